@@ -7,6 +7,8 @@
 
 #include "cli.h"
 
+#include "qonlinerequestscheduler.h"
+#include "qonlinetranslationjob.h"
 #include "qonlinetts.h"
 #include "settings/appsettings.h"
 #include "transitions/playerstoppedtransition.h"
@@ -19,6 +21,7 @@
 #include <QMediaPlaylist>
 #include <QRegularExpression>
 #include <QStateMachine>
+#include <QTimer>
 
 Cli::Cli(QObject *parent)
     : QObject(parent)
@@ -27,6 +30,8 @@ Cli::Cli(QObject *parent)
     , m_stateMachine(new QStateMachine(this))
 {
     m_player->setPlaylist(new QMediaPlaylist);
+    m_translator->setScheduler(new QOnlineRequestScheduler(m_translator));
+    m_translator->setMaxRetries(2);
 
     connect(m_stateMachine, &QStateMachine::finished, QCoreApplication::instance(), &QCoreApplication::quit, Qt::QueuedConnection);
     // clang-format off
@@ -50,6 +55,7 @@ void Cli::process(const QCoreApplication &app)
     const QCommandLineOption audioOnly({"a", "audio-only"}, tr("Do not print any text when using --%1 or --%2.").arg(speakSource.names().at(1), speakTranslation.names().at(1)));
     const QCommandLineOption brief({"b", "brief"}, tr("Print only translations."));
     const QCommandLineOption json({"j", "json"}, tr("Print output formatted as JSON."));
+    const QCommandLineOption timings(QStringLiteral("timings"), tr("Include timings and retries of network requests into JSON output."));
 
     QCommandLineParser parser;
     parser.setApplicationDescription(tr("A simple and lightweight translator that allows to translate and speak text using Google, Yandex, Bing, LibreTranslate and Lingva"));
@@ -68,6 +74,7 @@ void Cli::process(const QCoreApplication &app)
     parser.addOption(audioOnly);
     parser.addOption(brief);
     parser.addOption(json);
+    parser.addOption(timings);
     parser.process(app);
 
     checkIncompatibleOptions(parser, audioOnly, brief);
@@ -79,6 +86,11 @@ void Cli::process(const QCoreApplication &app)
         parser.showHelp();
     }
 
+    if (parser.isSet(timings) && !parser.isSet(json)) {
+        qCritical() << tr("Error: For --%1 you must specify --%2 option").arg(timings.names().at(0), json.names().at(1)) << '\n';
+        parser.showHelp();
+    }
+
     // Only show language codes
     if (parser.isSet(codes)) {
         buildShowCodesStateMachine();
@@ -139,6 +151,7 @@ void Cli::process(const QCoreApplication &app)
     m_audioOnly = parser.isSet(audioOnly);
     m_brief = parser.isSet(brief);
     m_json = parser.isSet(json);
+    m_translator->setTimingsEnabled(parser.isSet(timings));
     if (m_brief || m_audioOnly) {
         m_translator->setExamplesEnabled(false);
         m_translator->setTranslationOptionsEnabled(false);
@@ -151,49 +164,73 @@ void Cli::process(const QCoreApplication &app)
     m_stateMachine->start();
 }
 
+// Translate to several languages at the same time, results are still printed in the order of languages
+void Cli::startTranslations()
+{
+    while (m_runningJobs < s_maxConcurrentTranslations && m_startedJobs < m_jobs.size()) {
+        const int index = m_startedJobs++;
+        QOnlineTranslationJob *job = m_translator->startTranslation(m_sourceText, m_engine, m_translationLanguages.at(index), m_sourceLang, m_uiLang);
+        m_jobs[index] = job;
+        ++m_runningJobs;
+
+        connect(job, &QOnlineTranslationJob::finished, this, [this, index] {
+            --m_runningJobs;
+            startTranslations();
+            if (index == m_currentJobIndex)
+                emit currentTranslationFinished();
+        });
+    }
+}
+
 void Cli::requestTranslation()
 {
     auto *state = qobject_cast<QState *>(sender());
-    auto translationLang = state->property(s_langProperty).value<QOnlineTranslator::Language>();
+    m_currentJobIndex = state->property(s_jobIndexProperty).toInt();
 
-    m_translator->translate(m_sourceText, m_engine, translationLang, m_sourceLang, m_uiLang);
+    // The translation could finish while previous results were printed or spoken
+    const QOnlineTranslationJob *job = m_jobs.at(m_currentJobIndex);
+    if (job != nullptr && !job->isRunning())
+        QTimer::singleShot(0, this, &Cli::currentTranslationFinished);
 }
 
 void Cli::parseTranslation()
 {
-    if (m_translator->error() != QOnlineTranslator::NoError) {
-        qCritical() << tr("Error: %1").arg(m_translator->errorString());
+    const QOnlineTranslationJob *job = m_jobs.at(m_currentJobIndex);
+    if (job->error() != QOnlineTranslator::NoError) {
+        qCritical() << tr("Error: %1").arg(job->errorString());
         m_stateMachine->stop();
         return;
     }
 
     if (m_sourceLang == QOnlineTranslator::Auto)
-        m_sourceLang = m_translator->sourceLanguage();
+        m_sourceLang = job->sourceLanguage();
 }
 
 void Cli::printTranslation()
 {
+    const QOnlineTranslationJob *job = m_jobs.at(m_currentJobIndex);
+
     // JSON mode
     if (m_json) {
-        m_stdout << m_translator->toJson().toJson();
+        m_stdout << job->toJson().toJson();
         return;
     }
 
     // Short mode
     if (m_brief) {
 #if QT_VERSION >= QT_VERSION_CHECK(5, 14, 0)
-        m_stdout << m_translator->translation() << Qt::endl;
+        m_stdout << job->translation() << Qt::endl;
 #else
-        m_stdout << m_translator->translation() << endl;
+        m_stdout << job->translation() << endl;
 #endif
         return;
     }
 
     // Show source text and its transliteration only once
     if (!m_sourcePrinted) {
-        m_stdout << m_translator->source() << '\n';
-        if (!m_translator->sourceTranslit().isEmpty()) {
-            QString translit = m_translator->sourceTranslit();
+        m_stdout << job->source() << '\n';
+        if (!job->sourceTranslit().isEmpty()) {
+            QString translit = job->sourceTranslit();
             m_stdout << '(' << translit.replace('\n', QStringLiteral(")\n(")) << ")\n";
         }
         m_sourcePrinted = true;
@@ -201,23 +238,23 @@ void Cli::printTranslation()
     m_stdout << '\n';
 
     // Languages
-    m_stdout << "[ " << m_translator->sourceLanguageName() << " -> ";
-    m_stdout << m_translator->translationLanguageName() << " ]\n\n";
+    m_stdout << "[ " << job->sourceLanguageName() << " -> ";
+    m_stdout << job->translationLanguageName() << " ]\n\n";
 
     // Translation and its transliteration
-    if (!m_translator->translation().isEmpty()) {
-        m_stdout << m_translator->translation() << '\n';
-        if (!m_translator->translationTranslit().isEmpty()) {
-            QString translit = m_translator->translationTranslit();
+    if (!job->translation().isEmpty()) {
+        m_stdout << job->translation() << '\n';
+        if (!job->translationTranslit().isEmpty()) {
+            QString translit = job->translationTranslit();
             m_stdout << '/' << translit.replace('\n', QStringLiteral("/\n/")) << "/\n";
         }
         m_stdout << '\n';
     }
 
     // Translation options
-    if (!m_translator->translationOptions().isEmpty()) {
-        m_stdout << tr("%1 - translation options:").arg(m_translator->source()) << '\n';
-        const QMap<QString, QVector<QOption>> translationOptions = m_translator->translationOptions();
+    if (!job->translationOptions().isEmpty()) {
+        m_stdout << tr("%1 - translation options:").arg(job->source()) << '\n';
+        const QMap<QString, QVector<QOption>> translationOptions = job->translationOptions();
         for (auto it = translationOptions.cbegin(); it != translationOptions.cend(); ++it) {
             m_stdout << it.key() << '\n';
             for (const auto &[word, gender, translations] : it.value()) {
@@ -232,9 +269,9 @@ void Cli::printTranslation()
     }
 
     // Examples
-    if (!m_translator->examples().isEmpty()) {
-        m_stdout << tr("%1 - examples:").arg(m_translator->source()) << '\n';
-        const QMap<QString, QVector<QExample>> examples = m_translator->examples();
+    if (!job->examples().isEmpty()) {
+        m_stdout << tr("%1 - examples:").arg(job->source()) << '\n';
+        const QMap<QString, QVector<QExample>> examples = job->examples();
         for (auto it = examples.cbegin(); it != examples.cend(); ++it) {
             m_stdout << it.key() << '\n';
             for (const auto &[example, description] : it.value()) {
@@ -278,7 +315,8 @@ void Cli::speakSource()
 
 void Cli::speakTranslation()
 {
-    speak(m_translator->translation(), m_translator->translationLanguage());
+    const QOnlineTranslationJob *job = m_jobs.at(m_currentJobIndex);
+    speak(job->translation(), job->translationLanguage());
 }
 
 void Cli::buildShowCodesStateMachine()
@@ -295,26 +333,33 @@ void Cli::buildTranslationStateMachine()
     auto *nextTranslationState = new QState(m_stateMachine);
     m_stateMachine->setInitialState(nextTranslationState);
 
-    for (QOnlineTranslator::Language lang : qAsConst(m_translationLanguages)) {
+    const bool onlyDetectLanguage = m_audioOnly && m_speakSource && !m_speakTranslation && m_sourceLang == QOnlineTranslator::Auto;
+    if (!onlyDetectLanguage) {
+        m_jobs.resize(m_translationLanguages.size());
+        connect(m_stateMachine, &QStateMachine::started, this, &Cli::startTranslations);
+    }
+
+    for (int i = 0; i < m_translationLanguages.size(); ++i) {
         auto *requestTranslationState = nextTranslationState;
         auto *parseDataState = new QState(m_stateMachine);
         auto *speakSourceText = new QState(m_stateMachine);
         auto *speakTranslation = new QState(m_stateMachine);
         nextTranslationState = new QState(m_stateMachine);
 
-        if (m_audioOnly && m_speakSource && !m_speakTranslation && m_sourceLang == QOnlineTranslator::Auto) {
+        if (onlyDetectLanguage) {
             connect(requestTranslationState, &QState::entered, this, &Cli::requestLanguage);
             connect(parseDataState, &QState::entered, this, &Cli::parseLanguage);
+            requestTranslationState->addTransition(m_translator, &QOnlineTranslator::finished, parseDataState);
         } else {
             connect(requestTranslationState, &QState::entered, this, &Cli::requestTranslation);
             connect(parseDataState, &QState::entered, this, &Cli::parseTranslation);
             if (!m_audioOnly)
                 connect(parseDataState, &QState::entered, this, &Cli::printTranslation);
 
-            requestTranslationState->setProperty(s_langProperty, lang);
+            requestTranslationState->setProperty(s_jobIndexProperty, i);
+            requestTranslationState->addTransition(this, &Cli::currentTranslationFinished, parseDataState);
         }
 
-        requestTranslationState->addTransition(m_translator, &QOnlineTranslator::finished, parseDataState);
         parseDataState->addTransition(speakSourceText);
 
         if (m_speakSource) {
@@ -29,7 +29,11 @@ public:
 
     void process(const QCoreApplication &app);
 
+signals:
+    void currentTranslationFinished();
+
 private slots:
+    void startTranslations();
     void requestTranslation();
     void parseTranslation();
     void printTranslation();
@@ -54,7 +58,8 @@ private:
     static QByteArray readFilesFromStdin();
     static QByteArray readFilesFromArguments(const QStringList &arguments);
 
-    static constexpr char s_langProperty[] = "Language";
+    static constexpr char s_jobIndexProperty[] = "JobIndex";
+    static constexpr int s_maxConcurrentTranslations = 10;
 
     QMediaPlayer *m_player;
     QOnlineTranslator *m_translator;
@@ -63,6 +68,10 @@ private:
 
     QString m_sourceText;
     QVector<QOnlineTranslator::Language> m_translationLanguages;
+    QVector<QOnlineTranslationJob *> m_jobs; // For each translation language, nullptr until started
+    int m_startedJobs = 0;
+    int m_runningJobs = 0;
+    int m_currentJobIndex = 0;
     QOnlineTranslator::Engine m_engine = QOnlineTranslator::Google;
     QOnlineTranslator::Language m_sourceLang = QOnlineTranslator::NoLanguage;
     QOnlineTranslator::Language m_uiLang = QOnlineTranslator::NoLanguage;
@@ -25,8 +25,7 @@ LanguagesDialog::LanguagesDialog(const QVector<QOnlineTranslator::Language> &cur
     connect(m_acceptShortcut, &QShortcut::activated, this, &LanguagesDialog::accept);
 
     // Load languages
-    for (int i = 1; i <= QOnlineTranslator::Zulu; ++i) {
-        const auto lang = static_cast<QOnlineTranslator::Language>(i);
+    for (QOnlineTranslator::Language lang : QOnlineTranslator::supportedLanguages()) {
         if (!currentLang.contains(lang))
             addLanguage(ui->availableLanguagesListWidget, lang);
     }
@@ -10,6 +10,9 @@
 
 #include "popupwindow.h"
 #include "qhotkey.h"
+#include "qlanguageidentifier.h"
+#include "qonlinerequestscheduler.h"
+#include "qonlinetranslationcache.h"
 #include "screenwatcher.h"
 #include "selection.h"
 #include "singleapplication.h"
@@ -96,6 +99,7 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->sourceLanguagesWidget, &LanguageButtonsWidget::buttonChecked, this, &MainWindow::checkLanguageButton);
     connect(ui->translationLanguagesWidget, &LanguageButtonsWidget::buttonChecked, this, &MainWindow::checkLanguageButton);
     connect(ui->sourceEdit, &SourceTextEdit::textChanged, this, &MainWindow::resetAutoSourceButtonText);
+    connect(ui->engineComboBox, qOverload<int>(&QComboBox::currentIndexChanged), this, &MainWindow::warmUpTranslator);
 
     // OCR logic
     connect(m_screenGrabber, &AbstractScreenGrabber::grabbed, m_snippingArea, &SnippingArea::snip);
@@ -107,6 +111,19 @@ MainWindow::MainWindow(QWidget *parent)
     ui->sourceSpeakButtons->setMediaPlayer(new QMediaPlayer);
     ui->translationSpeakButtons->setMediaPlayer(new QMediaPlayer);
 
+    // Translate only edited sentences of long texts
+    m_translator->setIncrementalTranslationEnabled(true);
+
+    // Back off from engines that reject requests and repeat requests after network failures.
+    // The user is waiting for the result, so do not postpone requests for minutes
+    auto *scheduler = new QOnlineRequestScheduler(m_translator);
+    scheduler->setMaxBackoff(30000);
+    m_translator->setScheduler(scheduler);
+    m_translator->setMaxRetries(2);
+
+    // Show parts of long translations as they arrive
+    connect(m_translator, &QOnlineTranslator::partialTranslationAvailable, this, &MainWindow::displayPartialTranslation);
+
     // State machine to handle translator signals async
     buildStateMachine();
     m_stateMachine->start();
@@ -189,8 +206,16 @@ Ocr *MainWindow::ocr() const
     return m_ocr;
 }
 
+void MainWindow::clearTranslationCache()
+{
+    if (m_translator->cache() != nullptr)
+        m_translator->cache()->clear();
+}
+
 void MainWindow::open()
 {
+    warmUpTranslator();
+
     ui->sourceEdit->setFocus();
     ui->sourceEdit->selectAll();
 
@@ -207,6 +232,7 @@ void MainWindow::open()
 
 void MainWindow::translateSelection()
 {
+    warmUpTranslator();
     emit translateSelectionRequested();
 }
 
@@ -217,6 +243,7 @@ void MainWindow::speakSelection()
 
 void MainWindow::speakTranslatedSelection()
 {
+    warmUpTranslator();
     emit speakTranslatedSelectionRequested();
 }
 
@@ -234,6 +261,7 @@ void MainWindow::playPauseSpeaking()
 
 void MainWindow::copyTranslatedSelection()
 {
+    warmUpTranslator();
     emit copyTranslatedSelectionRequested();
 }
 
@@ -328,13 +356,23 @@ void MainWindow::quit()
 
 void MainWindow::requestTranslation()
 {
+    const QString sourceText = ui->sourceEdit->toSourceText();
+
     QOnlineTranslator::Language translationLang;
-    if (ui->translationLanguagesWidget->isAutoButtonChecked())
-        translationLang = preferredTranslationLanguage(ui->sourceLanguagesWidget->checkedLanguage());
-    else
+    if (ui->translationLanguagesWidget->isAutoButtonChecked()) {
+        // Identify the source language locally to avoid re-translation if it is the same as the primary language
+        QOnlineTranslator::Language sourceLang = ui->sourceLanguagesWidget->checkedLanguage();
+        if (sourceLang == QOnlineTranslator::Auto) {
+            const QLanguageIdentifier::Result result = QLanguageIdentifier::identify(sourceText);
+            if (result.confidence >= m_translator->offlineDetectionThreshold())
+                sourceLang = result.language;
+        }
+        translationLang = preferredTranslationLanguage(sourceLang);
+    } else {
         translationLang = ui->translationLanguagesWidget->checkedLanguage();
+    }
 
-    m_translator->translate(ui->sourceEdit->toSourceText(), currentEngine(), translationLang, ui->sourceLanguagesWidget->checkedLanguage());
+    m_translator->translate(sourceText, currentEngine(), translationLang, ui->sourceLanguagesWidget->checkedLanguage());
 }
 
 // Re-translate to a secondary or a primary language if the autodetected source language and the translation language are the same
@@ -367,6 +405,15 @@ void MainWindow::displayTranslation()
         m_trayIcon->showTranslationMessage(ui->translationEdit->toPlainText());
 }
 
+void MainWindow::displayPartialTranslation(int offset, const QString &text)
+{
+    // The text will be translated again into another language
+    if (m_translator->sourceLanguage() == m_translator->translationLanguage())
+        return;
+
+    ui->translationEdit->parsePartialTranslation(m_translator, offset, text);
+}
+
 void MainWindow::clearTranslation()
 {
     ui->translationEdit->clearTranslation();
@@ -469,6 +516,12 @@ void MainWindow::minimize()
     setWindowState(windowState() | Qt::WindowMinimized);
 }
 
+// Open connections while the user is selecting text or languages to not wait for them on translation
+void MainWindow::warmUpTranslator()
+{
+    m_translator->warmUp(currentEngine());
+}
+
 void MainWindow::markContentAsChanged()
 {
     if (m_listenForContentChanges) {
@@ -930,6 +983,20 @@ void MainWindow::loadAppSettings()
     m_translator->setTranslationOptionsEnabled(settings.isTranslationOptionsEnabled());
     m_translator->setExamplesEnabled(settings.isExamplesEnabled());
     ui->sourceEdit->setSimplifySource(settings.isSimplifySource());
+
+    // Reuse results for already translated text
+    const AppSettings::TranslationCacheMode cacheMode = settings.translationCacheMode();
+    const bool diskCacheEnabled = m_translator->cache() != nullptr && m_translator->cache()->maxDiskEntries() != 0;
+    delete m_translator->cache();
+    if (cacheMode != AppSettings::NoCache) {
+        auto *cache = new QOnlineTranslationCache(m_translator);
+        if (cacheMode == AppSettings::MemoryCache)
+            cache->setMaxDiskEntries(0);
+        m_translator->setCache(cache);
+    }
+    if (diskCacheEnabled && cacheMode != AppSettings::DiskCache)
+        QOnlineTranslationCache().clear(); // Do not keep translations on disk after disabling it
+
     m_primaryLanguage = settings.primaryLanguage();
     m_secondaryLanguage = settings.secondaryLanguage();
     m_forceSourceAutodetect = settings.isForceSourceAutodetect();
@@ -55,6 +55,7 @@ public:
     const SpeakButtons *translationSpeakButtons() const;
     QKeySequence closeWindowShortcut() const;
     Ocr *ocr() const;
+    void clearTranslationCache();
 
 public slots:
     // Global shortcuts
@@ -97,6 +98,7 @@ private slots:
     void requestTranslation();
     void requestRetranslation();
     void displayTranslation();
+    void displayPartialTranslation(int offset, const QString &text);
     void clearTranslation();
 
     void requestSourceLanguage();
@@ -114,6 +116,7 @@ private slots:
     void minimize();
 
     // UI
+    void warmUpTranslator();
     void markContentAsChanged();
     void setListenForContentChanges(bool listen);
     void resetAutoSourceButtonText();
@@ -37,6 +37,14 @@ PopupWindow::PopupWindow(MainWindow *parent)
     // Translation edit
     ui->translationEdit->setFont(parent->translationEdit()->font());
     connect(parent->translationEdit(), &TranslationEdit::translationDataParsed, ui->translationEdit, &QTextEdit::setHtml);
+    connect(parent->translationEdit(), &TranslationEdit::translationPartParsed, ui->translationEdit, [this](const QString &part, bool first) {
+        if (first)
+            ui->translationEdit->clear();
+
+        QTextCursor cursor = ui->translationEdit->textCursor();
+        cursor.movePosition(QTextCursor::End);
+        cursor.insertText(part);
+    });
 
     // Player buttons
     ui->sourceSpeakButtons->setMediaPlayer(parent->sourceSpeakButtons()->mediaPlayer());
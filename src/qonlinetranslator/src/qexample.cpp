@@ -18,3 +18,12 @@ QJsonObject QExample::toJson() const
 
     return object;
 }
+
+QExample QExample::fromJson(const QJsonObject &object)
+{
+    QExample example;
+    example.example = object.value(QStringLiteral("example")).toString();
+    example.description = object.value(QStringLiteral("description")).toString();
+
+    return example;
+}
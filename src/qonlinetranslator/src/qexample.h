@@ -64,6 +64,14 @@ struct QExample {
      * @return JSON representation
      */
     QJsonObject toJson() const;
+
+    /**
+     * @brief Creates the object from JSON
+     *
+     * @param object JSON representation
+     * @return translation example
+     */
+    static QExample fromJson(const QJsonObject &object);
 };
 
 #endif // QEXAMPLE_H
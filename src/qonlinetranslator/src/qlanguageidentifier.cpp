@@ -0,0 +1,243 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "qlanguageidentifier.h"
+
+#include <QFile>
+#include <QtMath>
+
+#include <limits>
+
+QLanguageIdentifier::Result QLanguageIdentifier::identify(const QString &text)
+{
+    // The beginning is enough to identify long texts
+    const QString sample = text.left(s_maxSampleLength);
+
+    // Find the most used script
+    QHash<int, int> scriptLetters;
+    int letters = 0;
+    for (const QChar symbol : sample) {
+        if (symbol.isLetter()) {
+            ++scriptLetters[symbol.script()];
+            ++letters;
+        }
+    }
+
+    if (letters == 0)
+        return {};
+
+    auto script = QChar::Script_Unknown;
+    int dominantLetters = 0;
+    for (auto it = scriptLetters.cbegin(); it != scriptLetters.cend(); ++it) {
+        if (it.value() > dominantLetters) {
+            script = static_cast<QChar::Script>(it.key());
+            dominantLetters = it.value();
+        }
+    }
+
+    // Japanese mixes kana with Chinese characters
+    const int kanaLetters = scriptLetters.value(QChar::Script_Hiragana) + scriptLetters.value(QChar::Script_Katakana);
+    if (kanaLetters != 0 && script == QChar::Script_Han)
+        return {QOnlineTranslator::Japanese, static_cast<double>(dominantLetters + kanaLetters) / letters};
+
+    if (const QOnlineTranslator::Language language = scriptLanguage(sample, script); language != QOnlineTranslator::NoLanguage) {
+        const double confidence = static_cast<double>(dominantLetters) / letters;
+
+        // Yiddish texts can lack its specific letters and look like Hebrew
+        if (language == QOnlineTranslator::Hebrew)
+            return {language, qMin(confidence, s_ambiguousScriptConfidence)};
+
+        return {language, confidence};
+    }
+
+    // Compare n-grams with profiles of languages that use this script
+    const QHash<QString, int> ngrams = countNgrams(sample);
+    const Profile *bestProfile = nullptr;
+    qint64 bestCost = std::numeric_limits<qint64>::max();
+    qint64 secondCost = std::numeric_limits<qint64>::max();
+    for (const Profile &profile : profiles()) {
+        if (profile.script != script)
+            continue;
+
+        qint64 cost = 0;
+        for (auto it = ngrams.cbegin(); it != ngrams.cend(); ++it)
+            cost += static_cast<qint64>(it.value()) * profile.costs.value(it.key(), profile.unknownCost);
+
+        if (cost < bestCost) {
+            secondCost = bestCost;
+            bestCost = cost;
+            bestProfile = &profile;
+        } else if (cost < secondCost) {
+            secondCost = cost;
+        }
+    }
+
+    if (bestProfile == nullptr)
+        return {};
+
+    // The closest profile can still be a wrong language if the text language has no profile
+    int ngramsCount = 0;
+    for (const int count : ngrams)
+        ngramsCount += count;
+    if ((static_cast<double>(bestCost) / ngramsCount - bestProfile->expectedCost) / s_costScale > s_maxCostExcess)
+        return {};
+
+    if (secondCost == std::numeric_limits<qint64>::max())
+        return {bestProfile->language, static_cast<double>(dominantLetters) / letters};
+
+    // The difference is the logarithm of the likelihood ratio, short texts have a small difference
+    const double difference = (secondCost - bestCost) / s_costScale;
+    return {bestProfile->language, 1 - qExp(-difference / s_confidenceScale)};
+}
+
+const QVector<QLanguageIdentifier::Profile> &QLanguageIdentifier::profiles()
+{
+    static const QVector<Profile> profiles = loadProfiles();
+    return profiles;
+}
+
+QVector<QLanguageIdentifier::Profile> QLanguageIdentifier::loadProfiles()
+{
+    // Resources of static libraries should be initialized explicitly
+    Q_INIT_RESOURCE(languageprofiles);
+
+    QFile file(QStringLiteral(":/qonlinetranslator/languageprofiles.txt"));
+    if (!file.open(QFile::ReadOnly | QFile::Text))
+        return {};
+
+    QVector<Profile> profiles;
+    while (!file.atEnd()) {
+        const QString line = QString::fromUtf8(file.readLine()).trimmed();
+        if (line.isEmpty() || line.startsWith('#'))
+            continue;
+
+        const QStringList values = line.split(' ');
+        if (values.size() < 3)
+            continue;
+
+        Profile profile;
+        profile.language = QOnlineTranslator::language(values.at(0));
+        profile.unknownCost = values.at(1).toInt();
+        profile.costs.reserve(values.size() - 2);
+        for (int i = 2; i < values.size(); ++i) {
+            const QString &value = values.at(i);
+            const int separatorIndex = value.lastIndexOf(':');
+            QString ngram = value.left(separatorIndex);
+            ngram.replace('_', ' ');
+
+            // N-grams are sorted by frequency, so the first letter is from the main script
+            if (profile.script == QChar::Script_Unknown) {
+                for (const QChar symbol : qAsConst(ngram)) {
+                    if (symbol.isLetter()) {
+                        profile.script = symbol.script();
+                        break;
+                    }
+                }
+            }
+
+            profile.costs.insert(ngram, value.midRef(separatorIndex + 1).toInt());
+        }
+
+        // Frequency of each n-gram is e^(-cost / scale), the rest have the unknown cost
+        double knownFrequency = 0;
+        for (auto it = profile.costs.cbegin(); it != profile.costs.cend(); ++it) {
+            const double frequency = qExp(-it.value() / s_costScale);
+            knownFrequency += frequency;
+            profile.expectedCost += frequency * it.value();
+        }
+        profile.expectedCost += (1 - knownFrequency) * profile.unknownCost;
+
+        profiles.append(qMove(profile));
+    }
+
+    return profiles;
+}
+
+QHash<QString, int> QLanguageIdentifier::countNgrams(const QString &text)
+{
+    // Keep only letters separated by single spaces
+    QString words(1, ' ');
+    words.reserve(text.size() + 2);
+    for (const QChar symbol : text.toLower()) {
+        if (symbol.isLetter() || symbol.isMark())
+            words.append(symbol);
+        else if (!words.endsWith(' '))
+            words.append(' ');
+    }
+    if (!words.endsWith(' '))
+        words.append(' ');
+
+    // N-grams can contain a space only at the beginning or at the end
+    QHash<QString, int> ngrams;
+    for (int i = 0; i < words.size(); ++i) {
+        for (int length = 1; length <= s_maxNgramLength && i + length <= words.size(); ++length) {
+            if (length > 2 && words.at(i + length - 2) == ' ')
+                break;
+
+            const QStringRef ngram = words.midRef(i, length);
+            if (ngram != QLatin1String(" "))
+                ++ngrams[ngram.toString()];
+        }
+    }
+
+    return ngrams;
+}
+
+// Languages that are the only ones with their script
+QOnlineTranslator::Language QLanguageIdentifier::scriptLanguage(const QString &text, QChar::Script script)
+{
+    switch (script) {
+    case QChar::Script_Greek:
+        return QOnlineTranslator::Greek;
+    case QChar::Script_Armenian:
+        return QOnlineTranslator::Armenian;
+    case QChar::Script_Georgian:
+        return QOnlineTranslator::Georgian;
+    case QChar::Script_Hangul:
+        return QOnlineTranslator::Korean;
+    case QChar::Script_Hiragana:
+    case QChar::Script_Katakana:
+        return QOnlineTranslator::Japanese;
+    case QChar::Script_Thai:
+        return QOnlineTranslator::Thai;
+    case QChar::Script_Lao:
+        return QOnlineTranslator::Lao;
+    case QChar::Script_Khmer:
+        return QOnlineTranslator::Khmer;
+    case QChar::Script_Myanmar:
+        return QOnlineTranslator::Myanmar;
+    case QChar::Script_Sinhala:
+        return QOnlineTranslator::Sinhala;
+    case QChar::Script_Tamil:
+        return QOnlineTranslator::Tamil;
+    case QChar::Script_Telugu:
+        return QOnlineTranslator::Telugu;
+    case QChar::Script_Kannada:
+        return QOnlineTranslator::Kannada;
+    case QChar::Script_Malayalam:
+        return QOnlineTranslator::Malayalam;
+    case QChar::Script_Gujarati:
+        return QOnlineTranslator::Gujarati;
+    case QChar::Script_Gurmukhi:
+        return QOnlineTranslator::Punjabi;
+    case QChar::Script_Oriya:
+        return QOnlineTranslator::Oriya;
+    case QChar::Script_Bengali:
+        return QOnlineTranslator::Bengali;
+    case QChar::Script_Ethiopic:
+        return QOnlineTranslator::Amharic;
+    case QChar::Script_Hebrew:
+        // Yiddish uses ligatures and pointed alef that are not used in modern Hebrew
+        for (const QChar symbol : text) {
+            if ((symbol.unicode() >= 0x05F0 && symbol.unicode() <= 0x05F2) || symbol.unicode() == 0xFB2E || symbol.unicode() == 0xFB2F)
+                return QOnlineTranslator::Yiddish;
+        }
+        return QOnlineTranslator::Hebrew;
+    default:
+        return QOnlineTranslator::NoLanguage;
+    }
+}
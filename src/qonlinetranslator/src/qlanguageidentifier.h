@@ -0,0 +1,85 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef QLANGUAGEIDENTIFIER_H
+#define QLANGUAGEIDENTIFIER_H
+
+#include "qonlinetranslator.h"
+
+#include <QHash>
+
+/**
+ * @brief Identifies language of a text without network requests
+ *
+ * Languages with their own script (like Greek, Korean or Thai) are identified by the script.
+ * Other languages are identified by comparing character n-grams of the text with built-in profiles.
+ * Profiles cover only common languages. If the text fits even the closest profile much worse than texts
+ * of this language do, the language is considered unknown. Languages that are very close to a profiled one
+ * can still be identified as it, so the result should be used only when its confidence is high enough.
+ *
+ * Example:
+ * @code
+ * const QLanguageIdentifier::Result result = QLanguageIdentifier::identify(text);
+ * if (result.confidence >= 0.9)
+ *     qInfo() << QOnlineTranslator::languageName(result.language);
+ * @endcode
+ */
+class QLanguageIdentifier
+{
+public:
+    /**
+     * @brief Identified language
+     */
+    struct Result {
+        QOnlineTranslator::Language language = QOnlineTranslator::NoLanguage;
+        double confidence = 0; // From 0 to 1
+    };
+
+    /**
+     * @brief Identify language of the text
+     *
+     * Short texts have low confidence since they are similar in many languages.
+     *
+     * @param text text to identify
+     * @return the most probable language and confidence of the result,
+     * QOnlineTranslator::NoLanguage with zero confidence if the language is unknown
+     */
+    static Result identify(const QString &text);
+
+private:
+    struct Profile {
+        QOnlineTranslator::Language language = QOnlineTranslator::NoLanguage;
+        QChar::Script script = QChar::Script_Unknown;
+        int unknownCost = 0;
+        double expectedCost = 0; // Average cost of n-grams in a text of this language
+        QHash<QString, int> costs; // By n-gram, lower is more frequent
+    };
+
+    static const QVector<Profile> &profiles();
+    static QVector<Profile> loadProfiles();
+
+    static QHash<QString, int> countNgrams(const QString &text);
+    static QOnlineTranslator::Language scriptLanguage(const QString &text, QChar::Script script);
+
+    static constexpr int s_maxNgramLength = 3;
+    static constexpr int s_maxSampleLength = 1000;
+
+    // Costs in the profiles are multiplied by this value to store them as integers
+    static constexpr double s_costScale = 8;
+
+    // Difference of log-likelihoods between the best and the second languages that gives confidence 1 - 1 / e
+    static constexpr double s_confidenceScale = 5;
+
+    // Maximum excess of the average n-gram cost over the expected one (in nats) to trust the best profile.
+    // Texts in languages without profiles have many n-grams that are rare in the closest profile
+    static constexpr double s_maxCostExcess = 0.5;
+
+    // Confidence for languages that share the script with another language without a way to tell them apart
+    static constexpr double s_ambiguousScriptConfidence = 0.5;
+};
+
+#endif // QLANGUAGEIDENTIFIER_H
@@ -0,0 +1,171 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "qonlinebatchtranslationjob.h"
+
+#include "qonlinetranslationjob.h"
+
+#include <QTimer>
+
+QOnlineBatchTranslationJob::QOnlineBatchTranslationJob(QOnlineTranslator *translator)
+    : QObject(translator)
+    , m_translator(translator)
+    , m_finishTimer(new QTimer(this))
+{
+    // Report results asynchronously like QOnlineTranslationJob does
+    m_finishTimer->setSingleShot(true);
+    m_finishTimer->setInterval(0);
+    connect(m_finishTimer, &QTimer::timeout, this, &QOnlineBatchTranslationJob::finished);
+}
+
+void QOnlineBatchTranslationJob::translate(const QStringList &texts, QOnlineTranslator::Engine engine, QOnlineTranslator::Language translationLang, QOnlineTranslator::Language sourceLang)
+{
+    m_engine = engine;
+    m_translationLang = translationLang;
+    m_sourceLang = sourceLang;
+    m_sources = texts;
+    m_translations = texts; // Empty texts are not sent
+    m_concurrency = m_translator->engineConcurrency(engine);
+
+    // Pack consecutive texts, texts with line breaks can't be packed
+    const int limit = m_translator->engineChunkSize(engine);
+    Pack pack;
+    int packSize = 0;
+    for (int i = 0; i < texts.size(); ++i) {
+        const QString &text = texts.at(i);
+        const bool empty = text.trimmed().isEmpty();
+        const bool single = text.contains(s_separator) || text.contains('\r') || text.size() >= limit;
+        if (pack.count != 0 && (empty || single || packSize + 1 + text.size() > limit)) {
+            m_packs.enqueue(pack);
+            pack = {};
+        }
+
+        if (empty)
+            continue;
+
+        if (pack.count == 0) {
+            pack.first = i;
+            packSize = text.size();
+        } else {
+            packSize += 1 + text.size();
+        }
+        ++pack.count;
+
+        if (single) {
+            m_packs.enqueue(pack);
+            pack = {};
+        }
+    }
+    if (pack.count != 0)
+        m_packs.enqueue(pack);
+
+    startPacks();
+}
+
+void QOnlineBatchTranslationJob::abort()
+{
+    if (!isRunning())
+        return;
+
+    abortJobs();
+    m_error = QOnlineTranslator::NetworkError;
+    m_errorString = tr("Operation canceled");
+    m_finishTimer->start();
+}
+
+bool QOnlineBatchTranslationJob::isRunning() const
+{
+    return !m_packs.isEmpty() || !m_jobs.isEmpty() || m_finishTimer->isActive();
+}
+
+const QStringList &QOnlineBatchTranslationJob::sources() const
+{
+    return m_sources;
+}
+
+const QStringList &QOnlineBatchTranslationJob::translations() const
+{
+    return m_translations;
+}
+
+QOnlineTranslator::TranslationError QOnlineBatchTranslationJob::error() const
+{
+    return m_error;
+}
+
+const QString &QOnlineBatchTranslationJob::errorString() const
+{
+    return m_errorString;
+}
+
+// Translate next packs until the engine concurrency limit is reached
+void QOnlineBatchTranslationJob::startPacks()
+{
+    while (!m_packs.isEmpty() && m_jobs.size() < m_concurrency && m_translator != nullptr) {
+        const Pack pack = m_packs.dequeue();
+
+        auto *job = new QOnlineTranslationJob(m_translator);
+        job->setParent(this);
+        job->m_sourceTranslitEnabled = false;
+        job->m_translationTranslitEnabled = false;
+        job->m_sourceTranscriptionEnabled = false;
+        job->m_translationOptionsEnabled = false;
+        job->m_examplesEnabled = false;
+        m_jobs.insert(job, pack);
+
+        connect(job, &QOnlineTranslationJob::finished, this, [this, job] {
+            parsePack(job);
+        });
+        job->translate(m_sources.mid(pack.first, pack.count).join(s_separator), m_engine, m_translationLang, m_sourceLang, QOnlineTranslator::Auto);
+    }
+
+    if (m_jobs.isEmpty())
+        m_finishTimer->start();
+}
+
+void QOnlineBatchTranslationJob::parsePack(QOnlineTranslationJob *job)
+{
+    const Pack pack = m_jobs.take(job);
+    job->deleteLater();
+
+    if (job->error() != QOnlineTranslator::NoError) {
+        abortJobs();
+        m_error = job->error();
+        m_errorString = job->errorString();
+        m_finishTimer->start();
+        return;
+    }
+
+    if (pack.count == 1) {
+        m_translations[pack.first] = job->translation();
+    } else {
+        const QStringList lines = job->translation().split(s_separator);
+        if (lines.size() == pack.count) {
+            for (int i = 0; i < pack.count; ++i)
+                m_translations[pack.first + i] = lines.at(i).trimmed();
+        } else {
+            // The engine merged or split lines, translate texts of the pack one by one
+            for (int i = pack.count - 1; i >= 0; --i)
+                m_packs.prepend({pack.first + i, 1});
+        }
+    }
+
+    startPacks();
+}
+
+void QOnlineBatchTranslationJob::abortJobs()
+{
+    m_packs.clear();
+
+    const QList<QOnlineTranslationJob *> jobs = m_jobs.keys();
+    m_jobs.clear();
+    for (QOnlineTranslationJob *job : jobs) {
+        job->disconnect(this);
+        job->abort();
+        job->deleteLater();
+    }
+}
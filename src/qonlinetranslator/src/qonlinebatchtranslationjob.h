@@ -0,0 +1,120 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef QONLINEBATCHTRANSLATIONJOB_H
+#define QONLINEBATCHTRANSLATIONJOB_H
+
+#include "qonlinetranslator.h"
+
+#include <QHash>
+#include <QQueue>
+
+class QOnlineTranslationJob;
+
+/**
+ * @brief Provides translations of several texts
+ *
+ * Created by QOnlineTranslator::translateBatch().
+ * Texts are packed into requests as long as the engine limit allows, one text per line.
+ * If the engine merges or splits lines of a request, its texts are translated separately.
+ * Only translations are requested, transliteration, translation options and examples are not available.
+ */
+class QOnlineBatchTranslationJob : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(QOnlineBatchTranslationJob)
+
+    friend class QOnlineTranslator;
+
+public:
+    /**
+     * @brief Cancel translation operation (if any).
+     */
+    void abort();
+
+    /**
+     * @brief Check translation progress
+     *
+     * @return `true` when the translation is still processing and has not finished or was aborted yet.
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Source texts
+     *
+     * @return texts to translate
+     */
+    const QStringList &sources() const;
+
+    /**
+     * @brief Translated texts
+     *
+     * Empty texts are returned as is.
+     *
+     * @return translation for each source text in the same order
+     */
+    const QStringList &translations() const;
+
+    /**
+     * @brief Last error
+     *
+     * Translation stops on the first error.
+     *
+     * @return last error
+     * @sa QOnlineTranslationJob::error()
+     */
+    QOnlineTranslator::TranslationError error() const;
+
+    /**
+     * @brief Last error string
+     *
+     * @return last error string
+     */
+    const QString &errorString() const;
+
+signals:
+    /**
+     * @brief Translation finished
+     *
+     * This signal is called when all texts are translated or an error occurred.
+     */
+    void finished();
+
+private:
+    // Consecutive texts that are sent in one request
+    struct Pack {
+        int first = 0;
+        int count = 0;
+    };
+
+    explicit QOnlineBatchTranslationJob(QOnlineTranslator *translator);
+
+    void translate(const QStringList &texts, QOnlineTranslator::Engine engine, QOnlineTranslator::Language translationLang, QOnlineTranslator::Language sourceLang);
+    void startPacks();
+    void parsePack(QOnlineTranslationJob *job);
+    void abortJobs();
+
+    static constexpr char s_separator = '\n';
+
+    QPointer<QOnlineTranslator> m_translator;
+    QTimer *m_finishTimer;
+
+    QQueue<Pack> m_packs;
+    QHash<QOnlineTranslationJob *, Pack> m_jobs;
+    int m_concurrency = 1;
+
+    QOnlineTranslator::Engine m_engine = QOnlineTranslator::Google;
+    QOnlineTranslator::Language m_sourceLang = QOnlineTranslator::NoLanguage;
+    QOnlineTranslator::Language m_translationLang = QOnlineTranslator::NoLanguage;
+    QOnlineTranslator::TranslationError m_error = QOnlineTranslator::NoError;
+
+    QStringList m_sources;
+    QStringList m_translations;
+    QString m_errorString;
+};
+
+#endif // QONLINEBATCHTRANSLATIONJOB_H
@@ -0,0 +1,196 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "qonlinerequestscheduler.h"
+
+#include <QNetworkReply>
+#include <QTimer>
+#include <QtMath>
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+#include <QRandomGenerator>
+#endif
+
+QOnlineRequestScheduler::QOnlineRequestScheduler(QObject *parent)
+    : QObject(parent)
+{
+    m_clock.start();
+}
+
+double QOnlineRequestScheduler::requestRate(QOnlineTranslator::Engine engine) const
+{
+    return m_engines.value(engine).requestRate;
+}
+
+void QOnlineRequestScheduler::setRequestRate(QOnlineTranslator::Engine engine, double requestsPerSecond)
+{
+    EngineState &state = engineState(engine);
+    refillTokens(state);
+    state.requestRate = qMax(0.0, requestsPerSecond);
+    processQueue(engine);
+}
+
+int QOnlineRequestScheduler::burstSize(QOnlineTranslator::Engine engine) const
+{
+    return m_engines.value(engine).burstSize;
+}
+
+void QOnlineRequestScheduler::setBurstSize(QOnlineTranslator::Engine engine, int size)
+{
+    EngineState &state = engineState(engine);
+    refillTokens(state);
+    state.burstSize = qMax(1, size);
+    state.tokens = qMin(state.tokens, static_cast<double>(state.burstSize));
+    processQueue(engine);
+}
+
+int QOnlineRequestScheduler::maxOutstandingRequests(QOnlineTranslator::Engine engine) const
+{
+    return m_engines.value(engine).maxOutstandingRequests;
+}
+
+void QOnlineRequestScheduler::setMaxOutstandingRequests(QOnlineTranslator::Engine engine, int count)
+{
+    engineState(engine).maxOutstandingRequests = qMax(0, count);
+    processQueue(engine);
+}
+
+int QOnlineRequestScheduler::maxBackoff() const
+{
+    return m_maxBackoff;
+}
+
+void QOnlineRequestScheduler::setMaxBackoff(int msec)
+{
+    m_maxBackoff = qMax(0, msec);
+}
+
+void QOnlineRequestScheduler::schedule(QOnlineTranslator::Engine engine, QObject *context, Request request, int timeout, Expiration expiration)
+{
+    // The deadline starts now, so the wait in the queue is a part of the request time
+    const qint64 deadline = timeout > 0 ? m_clock.elapsed() + timeout : 0;
+    engineState(engine).queue.enqueue({context, qMove(request), deadline, qMove(expiration)});
+
+    // Requests may be scheduled while the caller is processing replies, so send them from the event loop
+    QTimer::singleShot(0, this, [this, engine] {
+        processQueue(engine);
+    });
+}
+
+void QOnlineRequestScheduler::reportSuccess(QOnlineTranslator::Engine engine)
+{
+    engineState(engine).serviceErrors = 0;
+}
+
+void QOnlineRequestScheduler::reportServiceError(QOnlineTranslator::Engine engine)
+{
+    EngineState &state = engineState(engine);
+    ++state.serviceErrors;
+
+    // Exponential backoff with equal jitter, so clients that were blocked together do not retry together
+    const qint64 backoff = qMin<qint64>(m_maxBackoff, s_initialBackoff << qMin(state.serviceErrors - 1, 16));
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+    const qint64 jitter = QRandomGenerator::global()->bounded(backoff / 2 + 1);
+#else
+    const qint64 jitter = qrand() % (backoff / 2 + 1);
+#endif
+    state.blockedUntil = qMax(state.blockedUntil, m_clock.elapsed() + backoff / 2 + jitter);
+}
+
+qint64 QOnlineRequestScheduler::backoff(QOnlineTranslator::Engine engine) const
+{
+    return qMax<qint64>(0, m_engines.value(engine).blockedUntil - m_clock.elapsed());
+}
+
+void QOnlineRequestScheduler::processQueue(QOnlineTranslator::Engine engine)
+{
+    EngineState &state = engineState(engine);
+    while (!state.queue.isEmpty()) {
+        // Finished requests will process the queue again
+        if (state.maxOutstandingRequests != 0 && state.outstandingRequests >= state.maxOutstandingRequests)
+            return;
+
+        const qint64 currentTime = m_clock.elapsed();
+        if (currentTime < state.blockedUntil) {
+            delayQueue(engine, state.blockedUntil);
+            return;
+        }
+
+        if (state.requestRate != 0) {
+            refillTokens(state);
+            if (state.tokens < 1) {
+                delayQueue(engine, currentTime + qCeil((1 - state.tokens) * 1000 / state.requestRate));
+                return;
+            }
+        }
+
+        const PendingRequest pendingRequest = state.queue.dequeue();
+        if (pendingRequest.context == nullptr)
+            continue;
+
+        QNetworkReply *reply = pendingRequest.request();
+        if (reply == nullptr)
+            continue;
+
+        if (state.requestRate != 0)
+            state.tokens -= 1;
+
+        ++state.outstandingRequests;
+        connect(reply, &QNetworkReply::finished, this, [this, engine] {
+            --engineState(engine).outstandingRequests;
+            processQueue(engine);
+        });
+    }
+}
+
+// Wait until the budget allows to send the next request, requests that can't wait so long expire now
+void QOnlineRequestScheduler::delayQueue(QOnlineTranslator::Engine engine, qint64 sendTime)
+{
+    EngineState &state = engineState(engine);
+    QVector<Expiration> expirations;
+    for (auto it = state.queue.begin(); it != state.queue.end();) {
+        if (it->deadline != 0 && it->deadline < sendTime) {
+            if (it->context != nullptr && it->expiration)
+                expirations.append(qMove(it->expiration));
+            it = state.queue.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    if (!state.queue.isEmpty()) {
+        const qint64 delay = sendTime - m_clock.elapsed();
+        if (!state.timer->isActive())
+            emit requestDelayed(engine, delay);
+        state.timer->start(static_cast<int>(delay));
+    }
+
+    // Called last since callers may schedule new requests
+    for (const Expiration &expiration : qAsConst(expirations))
+        expiration();
+}
+
+void QOnlineRequestScheduler::refillTokens(EngineState &state)
+{
+    const qint64 currentTime = m_clock.elapsed();
+    if (state.requestRate != 0)
+        state.tokens = qMin(static_cast<double>(state.burstSize), state.tokens + (currentTime - state.refillTime) * state.requestRate / 1000);
+    state.refillTime = currentTime;
+}
+
+QOnlineRequestScheduler::EngineState &QOnlineRequestScheduler::engineState(QOnlineTranslator::Engine engine)
+{
+    EngineState &state = m_engines[engine];
+    if (state.timer == nullptr) {
+        state.timer = new QTimer(this);
+        state.timer->setSingleShot(true);
+        connect(state.timer, &QTimer::timeout, this, [this, engine] {
+            processQueue(engine);
+        });
+    }
+    return state;
+}
@@ -0,0 +1,223 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef QONLINEREQUESTSCHEDULER_H
+#define QONLINEREQUESTSCHEDULER_H
+
+#include "qonlinetranslator.h"
+
+#include <QElapsedTimer>
+#include <QQueue>
+
+#include <functional>
+
+class QNetworkReply;
+class QTimer;
+
+/**
+ * @brief Limits requests to engines
+ *
+ * Engines block clients that send too many requests, so each engine has its own budget:
+ * - A token bucket that limits the request rate and allows short bursts.
+ * - A limit of requests that are sent and have not finished yet.
+ * - Exponential backoff with jitter after the engine reported QOnlineTranslator::ServiceError.
+ *
+ * Requests that exceed the budget are queued and sent in the order of scheduling when the budget allows.
+ * Queued requests that would wait longer than their timeout are dropped, see requestDelayed() to show the wait.
+ * All engines are unlimited by default.
+ *
+ * Example:
+ * @code
+ * auto *scheduler = new QOnlineRequestScheduler(translator);
+ * scheduler->setRequestRate(QOnlineTranslator::Google, 2);
+ * scheduler->setMaxOutstandingRequests(QOnlineTranslator::Google, 4);
+ * translator->setScheduler(scheduler);
+ * @endcode
+ */
+class QOnlineRequestScheduler : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(QOnlineRequestScheduler)
+
+public:
+    // Sends a request and returns its reply or nullptr if nothing was sent
+    using Request = std::function<QNetworkReply *()>;
+
+    // Called instead of the request if it can't be sent before its timeout
+    using Expiration = std::function<void()>;
+
+    /**
+     * @brief Create object
+     *
+     * @param parent parent object
+     */
+    explicit QOnlineRequestScheduler(QObject *parent = nullptr);
+
+    /**
+     * @brief Request rate of engine
+     *
+     * @param engine engine
+     * @return average number of requests per second, 0 if unlimited
+     * @sa setRequestRate()
+     */
+    double requestRate(QOnlineTranslator::Engine engine) const;
+
+    /**
+     * @brief Set request rate of engine
+     *
+     * @param engine engine
+     * @param requestsPerSecond average number of requests per second, 0 to remove the limit
+     */
+    void setRequestRate(QOnlineTranslator::Engine engine, double requestsPerSecond);
+
+    /**
+     * @brief Burst size of engine
+     *
+     * @param engine engine
+     * @return number of requests that can be sent at once after idle time
+     * @sa setBurstSize()
+     */
+    int burstSize(QOnlineTranslator::Engine engine) const;
+
+    /**
+     * @brief Set burst size of engine
+     *
+     * Only used when the request rate is limited.
+     *
+     * @param engine engine
+     * @param size number of requests that can be sent at once after idle time
+     */
+    void setBurstSize(QOnlineTranslator::Engine engine, int size);
+
+    /**
+     * @brief Maximum number of outstanding requests of engine
+     *
+     * @param engine engine
+     * @return maximum number of requests that are sent and not finished, 0 if unlimited
+     * @sa setMaxOutstandingRequests()
+     */
+    int maxOutstandingRequests(QOnlineTranslator::Engine engine) const;
+
+    /**
+     * @brief Set maximum number of outstanding requests of engine
+     *
+     * Limits all translations of the engine together,
+     * while QOnlineTranslator::setEngineConcurrency() limits parts of a single translation.
+     *
+     * @param engine engine
+     * @param count maximum number of requests that are sent and not finished, 0 to remove the limit
+     */
+    void setMaxOutstandingRequests(QOnlineTranslator::Engine engine, int count);
+
+    /**
+     * @brief Maximum backoff
+     *
+     * @return maximum time in milliseconds to postpone requests after service errors
+     * @sa setMaxBackoff()
+     */
+    int maxBackoff() const;
+
+    /**
+     * @brief Set maximum backoff
+     *
+     * The delay after each service error in a row is doubled until it reaches this value.
+     * Default is 5 minutes, interactive applications may prefer a shorter one.
+     *
+     * @param msec maximum time in milliseconds to postpone requests after service errors
+     */
+    void setMaxBackoff(int msec);
+
+    /**
+     * @brief Send request when the engine budget allows
+     *
+     * The request is always called asynchronously, even if the budget allows to send it now.
+     * It will not be called if the context object is destroyed.
+     * If the request can't be sent within the timeout from now, it's removed from the queue and the expiration is called instead,
+     * so the caller fails immediately instead of waiting for the end of the backoff.
+     *
+     * @param engine engine
+     * @param context object that owns the request
+     * @param request function that sends the request
+     * @param timeout maximum time in milliseconds to wait in the queue, 0 to wait without limit
+     * @param expiration function that is called if the request is not sent within the timeout
+     */
+    void schedule(QOnlineTranslator::Engine engine, QObject *context, Request request, int timeout = 0, Expiration expiration = {});
+
+    /**
+     * @brief Report successful response of engine
+     *
+     * Resets backoff of the engine.
+     *
+     * @param engine engine
+     */
+    void reportSuccess(QOnlineTranslator::Engine engine);
+
+    /**
+     * @brief Report service error of engine
+     *
+     * Postpones next requests of the engine. The delay is doubled after each error in a row.
+     *
+     * @param engine engine
+     */
+    void reportServiceError(QOnlineTranslator::Engine engine);
+
+    /**
+     * @brief Backoff of engine
+     *
+     * @param engine engine
+     * @return time in milliseconds until requests to the engine will be allowed again, 0 if allowed now
+     */
+    qint64 backoff(QOnlineTranslator::Engine engine) const;
+
+signals:
+    /**
+     * @brief Request is waiting for the engine budget
+     *
+     * Emitted when queued requests of the engine start waiting for the backoff or the request rate.
+     * Requests that wait for outstanding requests to finish do not emit it.
+     *
+     * @param engine engine
+     * @param msec time in milliseconds until the next request of the engine can be sent
+     */
+    void requestDelayed(QOnlineTranslator::Engine engine, qint64 msec);
+
+private:
+    struct PendingRequest {
+        QPointer<QObject> context;
+        Request request;
+        qint64 deadline = 0; // Time of the scheduler clock, 0 if unlimited
+        Expiration expiration;
+    };
+
+    struct EngineState {
+        QQueue<PendingRequest> queue;
+        double requestRate = 0;
+        int burstSize = s_defaultBurstSize;
+        int maxOutstandingRequests = 0;
+        double tokens = s_defaultBurstSize;
+        qint64 refillTime = 0;
+        int outstandingRequests = 0;
+        int serviceErrors = 0; // In a row
+        qint64 blockedUntil = 0;
+        QTimer *timer = nullptr; // Sends queued requests when tokens are refilled or backoff ends
+    };
+
+    void processQueue(QOnlineTranslator::Engine engine);
+    void delayQueue(QOnlineTranslator::Engine engine, qint64 sendTime);
+    void refillTokens(EngineState &state);
+    EngineState &engineState(QOnlineTranslator::Engine engine);
+
+    static constexpr int s_defaultBurstSize = 5;
+    static constexpr qint64 s_initialBackoff = 1000;
+    static constexpr int s_maxBackoff = 300000;
+
+    QMap<QOnlineTranslator::Engine, EngineState> m_engines;
+    QElapsedTimer m_clock;
+    int m_maxBackoff = s_maxBackoff;
+};
+
+#endif // QONLINEREQUESTSCHEDULER_H
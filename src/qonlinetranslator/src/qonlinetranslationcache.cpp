@@ -0,0 +1,219 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "qonlinetranslationcache.h"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+QOnlineTranslationCache::QOnlineTranslationCache(QObject *parent)
+    : QObject(parent)
+    , m_memoryCache(s_defaultMemoryEntries)
+    , m_directory(QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/translations"))
+{
+}
+
+bool QOnlineTranslationCache::find(const QString &key, Entry &entry)
+{
+    if (const Entry *cachedEntry = m_memoryCache.object(key)) {
+        entry = *cachedEntry;
+        if (m_maxDiskEntries != 0)
+            touchDiskEntry(filePath(key));
+        return true;
+    }
+
+    if (m_maxDiskEntries == 0)
+        return false;
+
+    const QString path = filePath(key);
+    QFile file(path);
+    if (!file.open(QFile::ReadOnly))
+        return false;
+
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+    const QJsonObject object = document.object();
+
+    // Hash collision or file from another version
+    if (object.value(QStringLiteral("key")).toString() != key)
+        return false;
+
+    file.close();
+    touchDiskEntry(path);
+
+    entry = fromJson(object);
+    m_memoryCache.insert(key, new Entry(entry));
+    return true;
+}
+
+void QOnlineTranslationCache::insert(const QString &key, const Entry &entry)
+{
+    m_memoryCache.insert(key, new Entry(entry));
+
+    if (m_maxDiskEntries == 0 || !QDir().mkpath(m_directory))
+        return;
+
+    const QString path = filePath(key);
+    const bool exists = QFile::exists(path);
+
+    QJsonObject object = toJson(entry);
+    object.insert(QStringLiteral("key"), key);
+
+    QSaveFile file(path);
+    if (!file.open(QFile::WriteOnly))
+        return;
+
+    file.write(QJsonDocument(object).toJson(QJsonDocument::Compact));
+    if (!file.commit() || exists)
+        return;
+
+    if (m_diskEntries == -1)
+        m_diskEntries = QDir(m_directory).entryList({QStringLiteral("*.json")}, QDir::Files).size();
+    else
+        ++m_diskEntries;
+
+    if (m_diskEntries > m_maxDiskEntries)
+        pruneDiskEntries();
+}
+
+void QOnlineTranslationCache::clear()
+{
+    m_memoryCache.clear();
+    QDir(m_directory).removeRecursively();
+    m_diskEntries = 0;
+}
+
+int QOnlineTranslationCache::maxMemoryEntries() const
+{
+    return m_memoryCache.maxCost();
+}
+
+void QOnlineTranslationCache::setMaxMemoryEntries(int count)
+{
+    m_memoryCache.setMaxCost(count);
+}
+
+int QOnlineTranslationCache::maxDiskEntries() const
+{
+    return m_maxDiskEntries;
+}
+
+void QOnlineTranslationCache::setMaxDiskEntries(int count)
+{
+    m_maxDiskEntries = qMax(0, count);
+    if (m_diskEntries > m_maxDiskEntries)
+        pruneDiskEntries();
+}
+
+const QString &QOnlineTranslationCache::directory() const
+{
+    return m_directory;
+}
+
+void QOnlineTranslationCache::setDirectory(const QString &directory)
+{
+    m_directory = directory;
+    m_diskEntries = -1;
+}
+
+QString QOnlineTranslationCache::filePath(const QString &key) const
+{
+    const QByteArray hash = QCryptographicHash::hash(key.toUtf8(), QCryptographicHash::Sha1).toHex();
+    return m_directory + '/' + hash + QStringLiteral(".json");
+}
+
+// Pruning removes files by modification time, so a hit should make the file the most recent one
+void QOnlineTranslationCache::touchDiskEntry(const QString &path)
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+    if (!QFile::exists(path))
+        return;
+
+    // Append mode does not truncate the file and allows to change its time on all platforms
+    QFile file(path);
+    if (file.open(QFile::Append))
+        file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+#else
+    Q_UNUSED(path)
+#endif
+}
+
+void QOnlineTranslationCache::pruneDiskEntries()
+{
+    // Remove the oldest files with some reserve to avoid pruning on every insertion
+    QFileInfoList files = QDir(m_directory).entryInfoList({QStringLiteral("*.json")}, QDir::Files, QDir::Time | QDir::Reversed);
+    const int targetCount = m_maxDiskEntries - m_maxDiskEntries / 10;
+    while (files.size() > targetCount) {
+        QFile::remove(files.takeFirst().filePath());
+    }
+    m_diskEntries = files.size();
+}
+
+QJsonObject QOnlineTranslationCache::toJson(const Entry &entry)
+{
+    QJsonObject translationOptions;
+    for (auto it = entry.translationOptions.cbegin(); it != entry.translationOptions.cend(); ++it) {
+        QJsonArray arr;
+        for (const QOption &option : it.value())
+            arr.append(option.toJson());
+        translationOptions.insert(it.key(), arr);
+    }
+
+    QJsonObject examples;
+    for (auto it = entry.examples.cbegin(); it != entry.examples.cend(); ++it) {
+        QJsonArray arr;
+        for (const QExample &example : it.value())
+            arr.append(example.toJson());
+        examples.insert(it.key(), arr);
+    }
+
+    QJsonObject object{
+        {"examples", qMove(examples)},
+        {"sourceLanguage", QOnlineTranslator::languageCode(entry.sourceLang)},
+        {"sourceTranscription", entry.sourceTranscription},
+        {"sourceTranslit", entry.sourceTranslit},
+        {"translation", entry.translation},
+        {"translationOptions", qMove(translationOptions)},
+        {"translationTranslit", entry.translationTranslit},
+    };
+
+    return object;
+}
+
+QOnlineTranslationCache::Entry QOnlineTranslationCache::fromJson(const QJsonObject &object)
+{
+    Entry entry;
+    entry.sourceLang = QOnlineTranslator::language(object.value(QStringLiteral("sourceLanguage")).toString());
+    entry.translation = object.value(QStringLiteral("translation")).toString();
+    entry.translationTranslit = object.value(QStringLiteral("translationTranslit")).toString();
+    entry.sourceTranslit = object.value(QStringLiteral("sourceTranslit")).toString();
+    entry.sourceTranscription = object.value(QStringLiteral("sourceTranscription")).toString();
+
+    const QJsonObject translationOptions = object.value(QStringLiteral("translationOptions")).toObject();
+    for (auto it = translationOptions.constBegin(); it != translationOptions.constEnd(); ++it) {
+        QVector<QOption> options;
+        for (const QJsonValue &option : it.value().toArray())
+            options.append(QOption::fromJson(option.toObject()));
+        entry.translationOptions.insert(it.key(), options);
+    }
+
+    const QJsonObject examples = object.value(QStringLiteral("examples")).toObject();
+    for (auto it = examples.constBegin(); it != examples.constEnd(); ++it) {
+        QVector<QExample> typeExamples;
+        for (const QJsonValue &example : it.value().toArray())
+            typeExamples.append(QExample::fromJson(example.toObject()));
+        entry.examples.insert(it.key(), typeExamples);
+    }
+
+    return entry;
+}
@@ -0,0 +1,139 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef QONLINETRANSLATIONCACHE_H
+#define QONLINETRANSLATIONCACHE_H
+
+#include "qonlinetranslator.h"
+
+#include <QCache>
+
+/**
+ * @brief Stores translation results in memory and on disk
+ *
+ * Results are stored in the in-memory LRU cache and in the directory on disk.
+ * When a result is not found in memory, it will be loaded from disk and moved to memory.
+ * Can be shared between multiple QOnlineTranslator instances.
+ *
+ * @sa QOnlineTranslator::setCache()
+ */
+class QOnlineTranslationCache : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(QOnlineTranslationCache)
+
+public:
+    /**
+     * @brief Cached translation result
+     */
+    struct Entry {
+        QOnlineTranslator::Language sourceLang = QOnlineTranslator::NoLanguage;
+        QString translation;
+        QString translationTranslit;
+        QString sourceTranslit;
+        QString sourceTranscription;
+        QMap<QString, QVector<QOption>> translationOptions;
+        QMap<QString, QVector<QExample>> examples;
+    };
+
+    /**
+     * @brief Create object
+     *
+     * Constructs an empty cache that stores files in `translations` subdirectory of the application data location.
+     *
+     * @param parent parent object
+     */
+    explicit QOnlineTranslationCache(QObject *parent = nullptr);
+
+    /**
+     * @brief Find result
+     *
+     * @param key key of the result
+     * @param entry found result
+     * @return `true` if the result was found
+     */
+    bool find(const QString &key, Entry &entry);
+
+    /**
+     * @brief Store result
+     *
+     * @param key key of the result
+     * @param entry result to store
+     */
+    void insert(const QString &key, const Entry &entry);
+
+    /**
+     * @brief Remove all results from memory and from disk
+     */
+    void clear();
+
+    /**
+     * @brief Maximum number of results in memory
+     *
+     * @return maximum number of results
+     */
+    int maxMemoryEntries() const;
+
+    /**
+     * @brief Set maximum number of results in memory
+     *
+     * Least recently used results will be removed first.
+     *
+     * @param count maximum number of results
+     */
+    void setMaxMemoryEntries(int count);
+
+    /**
+     * @brief Maximum number of results on disk
+     *
+     * @return maximum number of results
+     */
+    int maxDiskEntries() const;
+
+    /**
+     * @brief Set maximum number of results on disk
+     *
+     * Least recently used results will be removed first.
+     * Set to 0 to disable disk cache.
+     *
+     * @param count maximum number of results
+     */
+    void setMaxDiskEntries(int count);
+
+    /**
+     * @brief Directory of disk cache
+     *
+     * @return directory path
+     */
+    const QString &directory() const;
+
+    /**
+     * @brief Set directory of disk cache
+     *
+     * @param directory directory path
+     */
+    void setDirectory(const QString &directory);
+
+private:
+    QString filePath(const QString &key) const;
+    void pruneDiskEntries();
+
+    static void touchDiskEntry(const QString &path);
+
+    static QJsonObject toJson(const Entry &entry);
+    static Entry fromJson(const QJsonObject &object);
+
+    static constexpr int s_defaultMemoryEntries = 200;
+    static constexpr int s_defaultDiskEntries = 5000;
+
+    QCache<QString, Entry> m_memoryCache;
+    QString m_directory;
+    int m_maxDiskEntries = s_defaultDiskEntries;
+    int m_diskEntries = -1; // Counted lazily
+};
+
+#endif // QONLINETRANSLATIONCACHE_H
@@ -0,0 +1,2187 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "qonlinetranslationjob.h"
+
+#include "qlanguageidentifier.h"
+#include "qonlinerequestscheduler.h"
+#include "qonlinetranslationcache.h"
+
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QQueue>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QTextBoundaryFinder>
+#include <QTimer>
+
+#include <utility>
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+#include <QRandomGenerator>
+#endif
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 1, 0)
+#include <QNetworkInformation>
+#elif QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+#include <QNetworkConfigurationManager>
+#endif
+
+QOnlineTranslationJob::QOnlineTranslationJob(QOnlineTranslator *translator)
+    : QObject(translator)
+    , m_translator(translator)
+    , m_networkManager(translator->m_networkManager)
+    , m_cache(translator->m_cache)
+    , m_scheduler(translator->m_scheduler)
+    , m_finishTimer(new QTimer(this))
+    , m_hedgingTimer(new QTimer(this))
+    , m_hedgingEngine(translator->m_hedgingEngine)
+    , m_hedgingDelay(translator->m_hedgingDelay)
+    , m_libreApiKey(translator->m_libreApiKey)
+    , m_libreUrl(translator->m_libreUrl)
+    , m_lingvaUrl(translator->m_lingvaUrl)
+    , m_googleUrl(translator->m_googleUrl)
+    , m_yandexUrl(translator->m_yandexUrl)
+    , m_bingUrl(translator->m_bingUrl)
+    , m_engineConcurrency(translator->m_engineConcurrency)
+    , m_engineResponseTimeouts(translator->m_engineResponseTimeouts)
+    , m_engineTimeouts(translator->m_engineTimeouts)
+    , m_maxRetries(translator->m_maxRetries)
+    , m_engineChunkSizes(translator->m_engineChunkSizes)
+    , m_offlineDetectionThreshold(translator->m_offlineDetectionThreshold)
+    , m_sourceTranslitEnabled(translator->m_sourceTranslitEnabled)
+    , m_translationTranslitEnabled(translator->m_translationTranslitEnabled)
+    , m_sourceTranscriptionEnabled(translator->m_sourceTranscriptionEnabled)
+    , m_translationOptionsEnabled(translator->m_translationOptionsEnabled)
+    , m_examplesEnabled(translator->m_examplesEnabled)
+    , m_timingsEnabled(translator->m_timingsEnabled)
+    , m_incrementalTranslationEnabled(translator->m_incrementalTranslationEnabled)
+    , m_chunkSizeTuningEnabled(translator->m_chunkSizeTuningEnabled)
+{
+    // Results are always reported asynchronously (even from cache or for parameters errors),
+    // so the job can be connected after start and can be safely deleted from the slot
+    m_finishTimer->setSingleShot(true);
+    m_finishTimer->setInterval(0);
+    connect(m_finishTimer, &QTimer::timeout, this, [this] {
+        // Wait for the hedging engine if this one failed
+        if (m_error != QOnlineTranslator::NoError && (m_hedgingTimer->isActive() || m_hedgingJob != nullptr)) {
+            if (m_hedgingTimer->isActive()) {
+                m_hedgingTimer->stop();
+                startHedging();
+            }
+            return;
+        }
+
+        abortHedging();
+        shareResults();
+        emit finished();
+    });
+
+    m_hedgingTimer->setSingleShot(true);
+    connect(m_hedgingTimer, &QTimer::timeout, this, &QOnlineTranslationJob::startHedging);
+}
+
+QOnlineTranslationJob::~QOnlineTranslationJob()
+{
+    leaveRunningTranslation();
+}
+
+void QOnlineTranslationJob::translate(const QString &text, QOnlineTranslator::Engine engine, QOnlineTranslator::Language translationLang, QOnlineTranslator::Language sourceLang, QOnlineTranslator::Language uiLang)
+{
+    // Jobs waiting for the previous translation continue by themselves, so they will not receive results of the new one
+    leaveRunningTranslation();
+    abortRequests();
+    resetData();
+    m_finishTimer->stop();
+
+    m_onlyDetectLanguage = false;
+    m_engine = engine;
+    m_timings.clear();
+    m_timingsClock.start();
+    m_retryCount = 0;
+    m_bingCredentialsTime = -1;
+    m_source = text;
+    m_sourceLang = sourceLang;
+    m_requestedSourceLang = sourceLang;
+    m_translationLang = translationLang == QOnlineTranslator::Auto ? QOnlineTranslator::language(QLocale()) : translationLang;
+    m_uiLang = uiLang == QOnlineTranslator::Auto ? QOnlineTranslator::language(QLocale()) : uiLang;
+
+    // Keep the deadline when translating again after the leader left
+    if (m_hedgingDelay > 0 && m_hedgingEngine != engine && !m_hedgingTimer->isActive() && m_hedgingJob == nullptr)
+        m_hedgingTimer->start(m_hedgingDelay);
+
+    // Check if the selected languages are supported by the engine
+    if (!QOnlineTranslator::isSupportTranslation(engine, m_sourceLang)) {
+        resetData(QOnlineTranslator::ParametersError, tr("Selected source language %1 is not supported for %2").arg(QOnlineTranslator::languageName(m_sourceLang), QMetaEnum::fromType<QOnlineTranslator::Engine>().valueToKey(engine)));
+        m_finishTimer->start();
+        return;
+    }
+    if (!QOnlineTranslator::isSupportTranslation(engine, m_translationLang)) {
+        resetData(QOnlineTranslator::ParametersError, tr("Selected translation language %1 is not supported for %2").arg(QOnlineTranslator::languageName(m_translationLang), QMetaEnum::fromType<QOnlineTranslator::Engine>().valueToKey(engine)));
+        m_finishTimer->start();
+        return;
+    }
+    if (!QOnlineTranslator::isSupportTranslation(engine, m_uiLang)) {
+        resetData(QOnlineTranslator::ParametersError, tr("Selected ui language %1 is not supported for %2").arg(QOnlineTranslator::languageName(m_uiLang), QMetaEnum::fromType<QOnlineTranslator::Engine>().valueToKey(engine)));
+        m_finishTimer->start();
+        return;
+    }
+
+    m_cacheKey = cacheKey(m_source);
+    if (loadFromCache()) {
+        m_finishTimer->start();
+        return;
+    }
+
+    if (joinRunningTranslation())
+        return;
+
+    if (translateSegments())
+        return;
+
+    if (isOffline()) {
+        resetData(QOnlineTranslator::NetworkError, tr("Error: No network connection"));
+        m_finishTimer->start();
+        return;
+    }
+
+    switch (engine) {
+    case QOnlineTranslator::Google:
+        buildGooglePipeline();
+        break;
+    case QOnlineTranslator::Yandex:
+        buildYandexPipeline();
+        break;
+    case QOnlineTranslator::Bing:
+        buildBingPipeline();
+        break;
+    case QOnlineTranslator::LibreTranslate:
+        if (m_libreUrl.isEmpty()) {
+            resetData(QOnlineTranslator::ParametersError, tr("%1 URL can't be empty.").arg(QMetaEnum::fromType<QOnlineTranslator::Engine>().valueToKey(engine)));
+            m_finishTimer->start();
+            return;
+        }
+
+        buildLibrePipeline();
+        break;
+    case QOnlineTranslator::Lingva:
+        if (m_lingvaUrl.isEmpty()) {
+            resetData(QOnlineTranslator::ParametersError, tr("%1 URL can't be empty.").arg(QMetaEnum::fromType<QOnlineTranslator::Engine>().valueToKey(engine)));
+            m_finishTimer->start();
+            return;
+        }
+
+        buildLingvaPipeline();
+        break;
+    }
+
+    startSteps();
+}
+
+void QOnlineTranslationJob::detectLanguage(const QString &text, QOnlineTranslator::Engine engine)
+{
+    leaveRunningTranslation();
+    abortRequests();
+    resetData();
+    m_finishTimer->stop();
+
+    m_onlyDetectLanguage = true;
+    m_engine = engine;
+    m_timings.clear();
+    m_timingsClock.start();
+    m_bingCredentialsTime = -1;
+    m_retryCount = 0;
+    m_cacheKey.clear();
+    m_source = text;
+    m_sourceLang = QOnlineTranslator::Auto;
+    m_translationLang = QOnlineTranslator::English;
+    m_uiLang = QOnlineTranslator::language(QLocale());
+
+    // Skip the round trip if the language can be reliably identified locally
+    if (const QLanguageIdentifier::Result result = QLanguageIdentifier::identify(text); result.confidence >= m_offlineDetectionThreshold) {
+        m_sourceLang = result.language;
+        m_finishTimer->start();
+        return;
+    }
+
+    if (isOffline()) {
+        resetData(QOnlineTranslator::NetworkError, tr("Error: No network connection"));
+        m_finishTimer->start();
+        return;
+    }
+
+    switch (engine) {
+    case QOnlineTranslator::Google:
+        buildGoogleDetectPipeline();
+        break;
+    case QOnlineTranslator::Yandex:
+        buildYandexDetectPipeline();
+        break;
+    case QOnlineTranslator::Bing:
+        buildBingDetectPipeline();
+        break;
+    case QOnlineTranslator::LibreTranslate:
+        if (m_libreUrl.isEmpty()) {
+            resetData(QOnlineTranslator::ParametersError, tr("%1 URL can't be empty.").arg(QMetaEnum::fromType<QOnlineTranslator::Engine>().valueToKey(engine)));
+            m_finishTimer->start();
+            return;
+        }
+
+        buildLibreDetectPipeline();
+        break;
+    case QOnlineTranslator::Lingva:
+        if (m_lingvaUrl.isEmpty()) {
+            resetData(QOnlineTranslator::ParametersError, tr("%1 URL can't be empty.").arg(QMetaEnum::fromType<QOnlineTranslator::Engine>().valueToKey(engine)));
+            m_finishTimer->start();
+            return;
+        }
+
+        buildLingvaDetectPipeline();
+        break;
+    }
+
+    startSteps();
+}
+
+void QOnlineTranslationJob::abort()
+{
+    abortHedging();
+
+    // Report cancellation like an aborted reply does
+    if (m_leader != nullptr) {
+        leaveRunningTranslation();
+        resetData(QOnlineTranslator::NetworkError, tr("Operation canceled"));
+        m_finishTimer->start();
+        return;
+    }
+
+    leaveRunningTranslation();
+    abortRequests();
+}
+
+bool QOnlineTranslationJob::isRunning() const
+{
+    return !m_steps.isEmpty() || m_finishTimer->isActive() || m_leader != nullptr || m_hedgingJob != nullptr || !m_segmentJobs.isEmpty();
+}
+
+// Translate with the same parameters again
+void QOnlineTranslationJob::retranslate()
+{
+    translate(m_source, m_engine, m_translationLang, m_requestedSourceLang, m_uiLang);
+}
+
+void QOnlineTranslationJob::abortRequests()
+{
+    m_bingRetryPending = false;
+
+    // Results loaded from cache are delivered by the timer, the canceled state must be delivered instead
+    const bool finishing = m_finishTimer->isActive();
+    m_finishTimer->stop();
+
+    // Collect first because aborting a reply may trigger parsing that clears the steps
+    QVector<QPointer<QNetworkReply>> replies;
+    for (const Step &step : qAsConst(m_steps)) {
+        for (const Chunk &chunk : step.chunks) {
+            if (chunk.reply != nullptr)
+                replies.append(chunk.reply);
+        }
+    }
+    for (const QPointer<QNetworkReply> &reply : qAsConst(replies)) {
+        if (reply != nullptr)
+            reply->abort();
+    }
+
+    // Parts that wait for the scheduler have no replies to abort
+    if (finishing || !m_steps.isEmpty() || !m_segmentJobs.isEmpty()) {
+        resetData(QOnlineTranslator::NetworkError, tr("Operation canceled"));
+        m_finishTimer->start();
+    }
+}
+
+QJsonDocument QOnlineTranslationJob::toJson() const
+{
+    QJsonObject translationOptions;
+    for (auto it = m_translationOptions.cbegin(); it != m_translationOptions.cend(); ++it) {
+        QJsonArray arr;
+        for (const QOption &option : it.value())
+            arr.append(option.toJson());
+        translationOptions.insert(it.key(), arr);
+    }
+
+    QJsonObject examples;
+    for (auto it = m_examples.cbegin(); it != m_examples.cend(); ++it) {
+        QJsonArray arr;
+        for (const QExample &example : it.value())
+            arr.append(example.toJson());
+        examples.insert(it.key(), arr);
+    }
+
+    QJsonObject object{
+        {"examples", qMove(examples)},
+        {"source", m_source},
+        {"sourceTranscription", m_sourceTranscription},
+        {"sourceTranslit", m_sourceTranslit},
+        {"translation", m_translation},
+        {"translationOptions", qMove(translationOptions)},
+        {"translationTranslit", m_translationTranslit},
+    };
+
+    if (m_timingsEnabled) {
+        QJsonArray timings;
+        for (const QRequestTiming &timing : m_timings)
+            timings.append(timing.toJson());
+        object.insert(QStringLiteral("timings"), timings);
+        object.insert(QStringLiteral("retries"), m_retryCount);
+    }
+
+    return QJsonDocument(object);
+}
+
+const QString &QOnlineTranslationJob::source() const
+{
+    return m_source;
+}
+
+const QString &QOnlineTranslationJob::sourceTranslit() const
+{
+    return m_sourceTranslit;
+}
+
+const QString &QOnlineTranslationJob::sourceTranscription() const
+{
+    return m_sourceTranscription;
+}
+
+QString QOnlineTranslationJob::sourceLanguageName() const
+{
+    return QOnlineTranslator::languageName(m_sourceLang);
+}
+
+QOnlineTranslator::Language QOnlineTranslationJob::sourceLanguage() const
+{
+    return m_sourceLang;
+}
+
+QOnlineTranslator::Engine QOnlineTranslationJob::engine() const
+{
+    return m_engine;
+}
+
+const QString &QOnlineTranslationJob::translation() const
+{
+    return m_translation;
+}
+
+const QString &QOnlineTranslationJob::translationTranslit() const
+{
+    return m_translationTranslit;
+}
+
+QString QOnlineTranslationJob::translationLanguageName() const
+{
+    return QOnlineTranslator::languageName(m_translationLang);
+}
+
+QOnlineTranslator::Language QOnlineTranslationJob::translationLanguage() const
+{
+    return m_translationLang;
+}
+
+const QMap<QString, QVector<QOption>> &QOnlineTranslationJob::translationOptions() const
+{
+    return m_translationOptions;
+}
+
+const QMap<QString, QVector<QExample>> &QOnlineTranslationJob::examples() const
+{
+    return m_examples;
+}
+
+const QVector<QRequestTiming> &QOnlineTranslationJob::timings() const
+{
+    return m_timings;
+}
+
+int QOnlineTranslationJob::retryCount() const
+{
+    return m_retryCount;
+}
+
+QOnlineTranslator::TranslationError QOnlineTranslationJob::error() const
+{
+    return m_error;
+}
+
+const QString &QOnlineTranslationJob::errorString() const
+{
+    return m_errorString;
+}
+
+QNetworkReply *QOnlineTranslationJob::requestGoogleTranslate(const QString &text)
+{
+    // Request only data blocks that will be parsed, the response keeps positions of the skipped blocks
+    QString dataTypes = QStringLiteral("dt=t");
+    if (!m_onlyDetectLanguage) {
+        if (m_sourceTranslitEnabled || m_translationTranslitEnabled)
+            dataTypes += QLatin1String("&dt=rm");
+
+        // Dictionary and examples are parsed only for short text, examples are taken from the definitions block
+        if (m_source.size() < QOnlineTranslator::s_googleTranslateLimit) {
+            if (m_translationOptionsEnabled)
+                dataTypes += QLatin1String("&dt=bd");
+            if (m_examplesEnabled)
+                dataTypes += QLatin1String("&dt=md");
+        }
+    }
+
+    // Generate API url
+    QUrl url(engineUrl(m_googleUrl, QStringLiteral("https://translate.googleapis.com")) + "/translate_a/single");
+    url.setQuery(QStringLiteral("client=gtx&ie=UTF-8&oe=UTF-8&%1&sl=%2&tl=%3&hl=%4&q=%5")
+                     .arg(dataTypes, QOnlineTranslator::languageApiCode(QOnlineTranslator::Google, m_sourceLang), QOnlineTranslator::languageApiCode(QOnlineTranslator::Google, m_translationLang), QOnlineTranslator::languageApiCode(QOnlineTranslator::Google, m_uiLang), QUrl::toPercentEncoding(text)));
+
+    return m_networkManager->get(QNetworkRequest(url));
+}
+
+void QOnlineTranslationJob::parseGoogleTranslate()
+{
+    m_currentReply->deleteLater();
+
+    // Check for error
+    if (m_currentReply->error() != QNetworkReply::NoError) {
+        if (m_currentReply->error() == QNetworkReply::ServiceUnavailableError)
+            resetData(QOnlineTranslator::ServiceError, tr("Error: Engine systems have detected suspicious traffic from your computer network. Please try your request again later."));
+        else
+            resetData(QOnlineTranslator::NetworkError, m_currentReply->errorString());
+        return;
+    }
+
+    // Check availability of service
+    const QByteArray data = m_currentReply->readAll();
+    if (data.startsWith('<')) {
+        resetData(QOnlineTranslator::ServiceError, tr("Error: Engine systems have detected suspicious traffic from your computer network. Please try your request again later."));
+        return;
+    }
+
+    // Read Json
+    const QJsonDocument jsonResponse = QJsonDocument::fromJson(data);
+    const QJsonArray jsonData = jsonResponse.array();
+
+    if (m_sourceLang == QOnlineTranslator::Auto) {
+        // Parse language
+        m_sourceLang = QOnlineTranslator::language(QOnlineTranslator::Google, jsonData.at(2).toString());
+        if (m_sourceLang == QOnlineTranslator::NoLanguage) {
+            resetData(QOnlineTranslator::ParsingError, tr("Error: Unable to parse autodetected language"));
+            return;
+        }
+        if (m_onlyDetectLanguage)
+            return;
+    }
+
+    QOnlineTranslator::addSpaceBetweenParts(m_translation);
+    QOnlineTranslator::addSpaceBetweenParts(m_translationTranslit);
+    QOnlineTranslator::addSpaceBetweenParts(m_sourceTranslit);
+    const QJsonArray translationsData = jsonData.at(0).toArray();
+    for (const QJsonValue &translationData : translationsData) {
+        const QJsonArray translationArray = translationData.toArray();
+        m_translation.append(translationArray.at(0).toString());
+        if (m_translationTranslitEnabled)
+            m_translationTranslit.append(translationArray.at(2).toString());
+        if (m_sourceTranslitEnabled)
+            m_sourceTranslit.append(translationArray.at(3).toString());
+    }
+
+    if (m_source.size() >= QOnlineTranslator::s_googleTranslateLimit)
+        return;
+
+    // Translation options
+    if (m_translationOptionsEnabled) {
+        const QJsonArray translationOptionsData = jsonData.at(1).toArray();
+        for (const QJsonValue &typeOfSpeechData : translationOptionsData) {
+            const QJsonArray typeOfSpeechDataArray = typeOfSpeechData.toArray();
+            const QString typeOfSpeech = typeOfSpeechDataArray.at(0).toString();
+            const QJsonArray wordsData = typeOfSpeechDataArray.at(2).toArray();
+            for (const QJsonValue &wordData : wordsData) {
+                const QJsonArray wordDataArray = wordData.toArray();
+                const QString word = wordDataArray.at(0).toString();
+                const QString gender = wordDataArray.at(4).toString();
+                const QJsonArray translationsArray = wordDataArray.at(1).toArray();
+                QStringList translations;
+                translations.reserve(translationsArray.size());
+                for (const QJsonValue &wordTranslation : translationsArray)
+                    translations.append(wordTranslation.toString());
+                m_translationOptions[typeOfSpeech].append({word, gender, translations});
+            }
+        }
+    }
+
+    // Examples
+    if (m_examplesEnabled) {
+        const QJsonArray allExamplesData = jsonData.at(12).toArray();
+        for (const QJsonValue &examplesData : allExamplesData) {
+            const QJsonArray examplesDataArray = examplesData.toArray();
+            const QString typeOfSpeech = examplesDataArray.at(0).toString();
+
+            const QJsonArray examplesArray = examplesDataArray.at(1).toArray();
+            for (const QJsonValue &exampleData : examplesArray) {
+                const QJsonArray exampleArray = exampleData.toArray();
+                const QString example = exampleArray.at(2).toString();
+                const QString definition = exampleArray.at(0).toString();
+
+                m_examples[typeOfSpeech].append({example, definition});
+            }
+        }
+    }
+}
+
+QNetworkReply *QOnlineTranslationJob::requestYandexTranslate(const QString &text)
+{
+    QString lang;
+    if (m_sourceLang == QOnlineTranslator::Auto)
+        lang = QOnlineTranslator::languageApiCode(QOnlineTranslator::Yandex, m_translationLang);
+    else
+        lang = QOnlineTranslator::languageApiCode(QOnlineTranslator::Yandex, m_sourceLang) + '-' + QOnlineTranslator::languageApiCode(QOnlineTranslator::Yandex, m_translationLang);
+
+    // Generate API url
+    QUrl url(engineUrl(m_yandexUrl, QStringLiteral("https://translate.yandex.net")) + "/api/v1/tr.json/translate");
+    url.setQuery(QStringLiteral("ucid=%1&srv=android&text=%2&lang=%3")
+                     .arg(QOnlineTranslator::s_yandexUcid, QUrl::toPercentEncoding(text), lang));
+
+    // Setup request
+    QNetworkRequest request;
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
+    request.setUrl(url);
+
+    // Make reply
+    return m_networkManager->post(request, QByteArray());
+}
+
+void QOnlineTranslationJob::parseYandexTranslate()
+{
+    m_currentReply->deleteLater();
+
+    // Check for errors
+    if (m_currentReply->error() != QNetworkReply::NoError) {
+        // Network errors
+        if (m_currentReply->error() < QNetworkReply::ContentAccessDenied) {
+            resetData(QOnlineTranslator::NetworkError, m_currentReply->errorString());
+            return;
+        }
+
+        // Parse data to get request error type
+        QOnlineTranslator::s_yandexUcid.clear();
+        const QJsonDocument jsonResponse = QJsonDocument::fromJson(m_currentReply->readAll());
+        resetData(QOnlineTranslator::ServiceError, jsonResponse.object().value(QStringLiteral("message")).toString());
+        return;
+    }
+
+    // Read Json
+    const QJsonDocument jsonResponse = QJsonDocument::fromJson(m_currentReply->readAll());
+    const QJsonObject jsonData = jsonResponse.object();
+
+    // Parse language
+    if (m_sourceLang == QOnlineTranslator::Auto) {
+        QString sourceCode = jsonData.value(QStringLiteral("lang")).toString();
+        sourceCode = sourceCode.left(sourceCode.indexOf('-'));
+        m_sourceLang = QOnlineTranslator::language(QOnlineTranslator::Yandex, sourceCode);
+        if (m_sourceLang == QOnlineTranslator::NoLanguage) {
+            resetData(QOnlineTranslator::ParsingError, tr("Error: Unable to parse autodetected language"));
+            return;
+        }
+        if (m_onlyDetectLanguage)
+            return;
+    }
+
+    // Parse translation data
+    m_translation += jsonData.value(QStringLiteral("text")).toArray().at(0).toString();
+}
+
+QNetworkReply *QOnlineTranslationJob::requestYandexSourceTranslit(const QString &text)
+{
+    return requestYandexTranslit(m_sourceLang, text);
+}
+
+void QOnlineTranslationJob::parseYandexSourceTranslit()
+{
+    parseYandexTranslit(m_sourceTranslit);
+}
+
+QNetworkReply *QOnlineTranslationJob::requestYandexTranslationTranslit(const QString &text)
+{
+    return requestYandexTranslit(m_translationLang, text);
+}
+
+void QOnlineTranslationJob::parseYandexTranslationTranslit()
+{
+    parseYandexTranslit(m_translationTranslit);
+}
+
+QNetworkReply *QOnlineTranslationJob::requestYandexDictionary(const QString &text)
+{
+    // Check if language is supported (need to check here because language may be autodetected)
+    if (!QOnlineTranslator::isSupportDictionary(QOnlineTranslator::Yandex, m_sourceLang, m_translationLang) && !m_source.contains(' '))
+        return nullptr;
+
+    // Generate API url
+    QUrl url(engineUrl(m_yandexUrl, QStringLiteral("https://dictionary.yandex.net")) + "/dicservice.json/lookupMultiple");
+    url.setQuery(QStringLiteral("text=%1&ui=%2&dict=%3-%4")
+                     .arg(QUrl::toPercentEncoding(text), QOnlineTranslator::languageApiCode(QOnlineTranslator::Yandex, m_uiLang), QOnlineTranslator::languageApiCode(QOnlineTranslator::Yandex, m_sourceLang), QOnlineTranslator::languageApiCode(QOnlineTranslator::Yandex, m_translationLang)));
+
+    return m_networkManager->get(QNetworkRequest(url));
+}
+
+void QOnlineTranslationJob::parseYandexDictionary()
+{
+    m_currentReply->deleteLater();
+
+    if (m_currentReply->error() != QNetworkReply::NoError) {
+        resetData(QOnlineTranslator::NetworkError, m_currentReply->errorString());
+        return;
+    }
+
+    // Parse reply
+    const QJsonDocument jsonResponse = QJsonDocument::fromJson(m_currentReply->readAll());
+    const QJsonArray jsonData = jsonResponse.object().value(QOnlineTranslator::languageApiCode(QOnlineTranslator::Yandex, m_sourceLang) + '-' + QOnlineTranslator::languageApiCode(QOnlineTranslator::Yandex, m_translationLang)).toObject().value(QStringLiteral("regular")).toArray();
+
+    if (m_sourceTranscriptionEnabled)
+        m_sourceTranscription = jsonData.at(0).toObject().value(QStringLiteral("ts")).toString();
+
+    for (const QJsonValue &typeOfSpeechData : jsonData) {
+        const QJsonObject typeOfSpeechObject = typeOfSpeechData.toObject();
+        const QString typeOfSpeech = typeOfSpeechObject.value(QStringLiteral("pos")).toObject().value(QStringLiteral("text")).toString();
+        const QJsonArray wordsData = typeOfSpeechObject.value(QStringLiteral("tr")).toArray();
+        for (const QJsonValue &wordData : wordsData) {
+            // Parse translation options
+            const QJsonObject wordObject = wordData.toObject();
+            const QString word = wordObject.value(QStringLiteral("text")).toString();
+            const QString gender = wordObject.value(QStringLiteral("gen")).toObject().value(QStringLiteral("text")).toString();
+            const QJsonArray translationsArray = wordObject.value(QStringLiteral("mean")).toArray();
+            QStringList translations;
+            translations.reserve(translationsArray.size());
+            for (const QJsonValue &wordTranslation : translationsArray)
+                translations.append(wordTranslation.toObject().value(QStringLiteral("text")).toString());
+
+            m_translationOptions[typeOfSpeech].append({word, gender, translations});
+
+            // Parse examples
+            if (m_examplesEnabled && wordObject.contains(QLatin1String("ex"))) {
+                const QJsonArray examplesData = wordObject.value(QStringLiteral("ex")).toArray();
+                for (const QJsonValue &exampleData : examplesData) {
+                    const QJsonObject exampleObject = exampleData.toObject();
+                    const QString example = exampleObject.value(QStringLiteral("text")).toString();
+                    const QString description = exampleObject.value(QStringLiteral("tr")).toArray().first().toObject().value(QStringLiteral("text")).toString();
+
+                    m_examples[typeOfSpeech].append({example, description});
+                }
+            }
+        }
+    }
+}
+
+QNetworkReply *QOnlineTranslationJob::requestBingCredentials(const QString &)
+{
+    if (loadBingCredentials())
+        return nullptr;
+
+    m_bingMarkersState = 0;
+    m_bingCapturedMarker = -1;
+    m_bingFoundMarkers = 0;
+    for (QByteArray &value : m_bingMarkerValues)
+        value.clear();
+
+    const QUrl url(engineUrl(m_bingUrl, QStringLiteral("https://www.bing.com")) + "/translator");
+    QNetworkReply *reply = m_networkManager->get(QNetworkRequest(url));
+    connect(reply, &QNetworkReply::readyRead, this, [this, reply] {
+        scanBingCredentials(reply);
+    });
+    return reply;
+}
+
+void QOnlineTranslationJob::parseBingCredentials()
+{
+    m_currentReply->deleteLater();
+
+    // The reply is aborted as soon as all values are found, so check for errors only if something is missing
+    if (m_bingFoundMarkers != s_bingAllMarkers) {
+        if (m_currentReply->error() != QNetworkReply::NoError) {
+            resetData(QOnlineTranslator::NetworkError, m_currentReply->errorString());
+            return;
+        }
+        scanBingCredentials(m_currentReply);
+    }
+
+    if (!(m_bingFoundMarkers & (1 << BingCredentialsMarker))) {
+        resetData(QOnlineTranslator::ParsingError, tr("Error: Unable to find Bing credentials in web version."));
+        return;
+    }
+
+    // Credentials have the following format: key,"token",lifetime
+    const QByteArray &credentials = m_bingMarkerValues[BingCredentialsMarker];
+    const int keyEndPos = credentials.indexOf(',');
+    if (keyEndPos == -1) {
+        resetData(QOnlineTranslator::ParsingError, tr("Error: Unable to extract Bing key from web version."));
+        return;
+    }
+
+    const int tokenBeginPos = keyEndPos + 2; // Skip two symbols instead of one because the value is enclosed in quotes
+    const int tokenEndPos = credentials.indexOf('"', tokenBeginPos);
+    if (tokenEndPos == -1) {
+        resetData(QOnlineTranslator::ParsingError, tr("Error: Unable to extract Bing token from web version."));
+        return;
+    }
+
+    if (!(m_bingFoundMarkers & (1 << BingIgMarker)) || !(m_bingFoundMarkers & (1 << BingIidMarker))) {
+        resetData(QOnlineTranslator::ParsingError, tr("Error: Unable to extract additional Bing information from web version."));
+        return;
+    }
+
+    // Token is followed by its lifetime in milliseconds
+    bool lifetimeParsed = false;
+    const qint64 lifetime = credentials.mid(tokenEndPos + 2).toLongLong(&lifetimeParsed);
+
+    // Replace all values at once, so translators in other threads never see a mix of old and new credentials
+    {
+        QMutexLocker locker(&QOnlineTranslator::s_bingCredentialsMutex);
+        QOnlineTranslator::s_bingKey = credentials.left(keyEndPos);
+        QOnlineTranslator::s_bingToken = credentials.mid(tokenBeginPos, tokenEndPos - tokenBeginPos);
+        QOnlineTranslator::s_bingExpiration = QDateTime::currentDateTimeUtc().addMSecs(lifetimeParsed ? lifetime : s_bingDefaultLifetime);
+        QOnlineTranslator::s_bingIg = m_bingMarkerValues[BingIgMarker];
+        QOnlineTranslator::s_bingIid = m_bingMarkerValues[BingIidMarker];
+    }
+
+    m_bingCredentialsTime = m_timingsClock.elapsed();
+    saveBingCredentials();
+}
+
+// Search all markers in the received part of the web version in one pass and capture values after them
+void QOnlineTranslationJob::scanBingCredentials(QNetworkReply *reply)
+{
+    const BingMarkersAutomaton &automaton = bingMarkersAutomaton();
+    const QByteArray data = reply->readAll();
+    for (const char symbol : data) {
+        if (m_bingCapturedMarker != -1) {
+            QByteArray &value = m_bingMarkerValues[m_bingCapturedMarker];
+            if (symbol == s_bingMarkerTerminators[m_bingCapturedMarker]) {
+                m_bingFoundMarkers |= 1 << m_bingCapturedMarker;
+                m_bingCapturedMarker = -1;
+
+                // No need to download the rest of the page
+                if (m_bingFoundMarkers == s_bingAllMarkers) {
+                    reply->abort();
+                    return;
+                }
+            } else if (value.size() < s_bingMaxValueSize) {
+                value.append(symbol);
+            } else {
+                // Too long to be a value, probably a false match
+                value.clear();
+                m_bingCapturedMarker = -1;
+            }
+            continue;
+        }
+
+        m_bingMarkersState = automaton.transitions.at(m_bingMarkersState * 256 + static_cast<uchar>(symbol));
+        const int marker = automaton.matches.at(m_bingMarkersState);
+        if (marker != -1 && !(m_bingFoundMarkers & (1 << marker))) {
+            m_bingCapturedMarker = marker;
+            m_bingMarkersState = 0;
+        }
+    }
+}
+
+QNetworkReply *QOnlineTranslationJob::requestBingTranslate(const QString &text)
+{
+    QMutexLocker locker(&QOnlineTranslator::s_bingCredentialsMutex);
+
+    // Generate POST data
+    const QByteArray postData = "&text=" + QUrl::toPercentEncoding(text)
+        + "&fromLang=" + QOnlineTranslator::languageApiCode(QOnlineTranslator::Bing, m_sourceLang).toUtf8()
+        + "&to=" + QOnlineTranslator::languageApiCode(QOnlineTranslator::Bing, m_translationLang).toUtf8()
+        + "&token=" + QOnlineTranslator::s_bingToken
+        + "&key=" + QOnlineTranslator::s_bingKey;
+
+    QUrl url(engineUrl(m_bingUrl, QStringLiteral("https://www.bing.com")) + "/ttranslatev3");
+    url.setQuery(QStringLiteral("IG=%1&IID=%2").arg(QOnlineTranslator::s_bingIg, QOnlineTranslator::s_bingIid));
+    locker.unlock();
+
+    // Setup request
+    QNetworkRequest request;
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
+    request.setHeader(QNetworkRequest::UserAgentHeader, QCoreApplication::applicationName() + '/' + QCoreApplication::applicationVersion());
+    request.setUrl(url);
+
+    // Make reply
+    return m_networkManager->post(request, postData);
+}
+
+void QOnlineTranslationJob::parseBingTranslate()
+{
+    m_currentReply->deleteLater();
+
+    const QJsonDocument jsonResponse = QJsonDocument::fromJson(m_currentReply->readAll());
+    const QJsonObject errorObject = jsonResponse.object();
+    const QString errorMessage = errorObject.value(QStringLiteral("errorMessage")).toString();
+
+    // Saved credentials are rejected after expiration, the part will be sent again with new ones.
+    // It's not an overload of the service, so the error is not reported to the scheduler
+    const auto isAuthStatus = [](int status) {
+        return status == 401 || status == 403;
+    };
+    if (isAuthStatus(m_currentReply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt())
+        || isAuthStatus(errorObject.value(QStringLiteral("statusCode")).toInt())) {
+        m_bingRetryPending = true;
+        return;
+    }
+
+    // Check for errors
+    if (m_currentReply->error() != QNetworkReply::NoError) {
+        resetData(QOnlineTranslator::NetworkError, m_currentReply->errorString());
+        return;
+    }
+
+    if (!errorObject.value(QStringLiteral("statusCode")).isNull()) {
+        if (!errorMessage.isEmpty())
+            resetData(QOnlineTranslator::ServiceError, errorMessage);
+        else
+            resetData(QOnlineTranslator::ServiceError, tr("Error: Bing return unhandled network error"));
+        return;
+    }
+
+    // Parse translation data
+    const QJsonObject responseObject = jsonResponse.array().first().toObject();
+
+    if (m_sourceLang == QOnlineTranslator::Auto) {
+        const QString langCode = responseObject.value(QStringLiteral("detectedLanguage")).toObject().value(QStringLiteral("language")).toString();
+        m_sourceLang = QOnlineTranslator::language(QOnlineTranslator::Bing, langCode);
+        if (m_sourceLang == QOnlineTranslator::NoLanguage) {
+            resetData(QOnlineTranslator::ParsingError, tr("Error: Unable to parse autodetected language"));
+            return;
+        }
+        if (m_onlyDetectLanguage)
+            return;
+    }
+
+    const QJsonObject translationsObject = responseObject.value(QStringLiteral("translations")).toArray().first().toObject();
+    m_translation += translationsObject.value(QStringLiteral("text")).toString();
+    m_translationTranslit += translationsObject.value(QStringLiteral("transliteration")).toObject().value(QStringLiteral("text")).toString();
+}
+
+QNetworkReply *QOnlineTranslationJob::requestBingDictionary(const QString &text)
+{
+    // Check if language is supported (need to check here because language may be autodetected)
+    if (!QOnlineTranslator::isSupportDictionary(QOnlineTranslator::Bing, m_sourceLang, m_translationLang) && !m_source.contains(' '))
+        return nullptr;
+
+    // Generate POST data
+    const QByteArray postData = "&text=" + QUrl::toPercentEncoding(text)
+        + "&from=" + QOnlineTranslator::languageApiCode(QOnlineTranslator::Bing, m_sourceLang).toUtf8()
+        + "&to=" + QOnlineTranslator::languageApiCode(QOnlineTranslator::Bing, m_translationLang).toUtf8();
+
+    QNetworkRequest request;
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
+    request.setUrl(engineUrl(m_bingUrl, QStringLiteral("https://www.bing.com")) + "/tlookupv3");
+
+    return m_networkManager->post(request, postData);
+}
+
+void QOnlineTranslationJob::parseBingDictionary()
+{
+    m_currentReply->deleteLater();
+
+    // Check for errors
+    if (m_currentReply->error() != QNetworkReply::NoError) {
+        resetData(QOnlineTranslator::NetworkError, m_currentReply->errorString());
+        return;
+    }
+
+    const QJsonDocument jsonResponse = QJsonDocument::fromJson(m_currentReply->readAll());
+    const QJsonObject responseObject = jsonResponse.array().first().toObject();
+
+    const QJsonArray dictionaryArray = responseObject.value(QStringLiteral("translations")).toArray();
+    for (const QJsonValue &dictionaryData : dictionaryArray) {
+        const QJsonObject dictionaryObject = dictionaryData.toObject();
+        const QString typeOfSpeech = dictionaryObject.value(QStringLiteral("posTag")).toString().toLower();
+        const QString word = dictionaryObject.value(QStringLiteral("displayTarget")).toString().toLower();
+        const QJsonArray translationsArray = dictionaryObject.value(QStringLiteral("backTranslations")).toArray();
+        QStringList translations;
+        translations.reserve(translationsArray.size());
+        for (const QJsonValue &wordTranslation : translationsArray)
+            translations.append(wordTranslation.toObject().value(QStringLiteral("displayText")).toString());
+
+        m_translationOptions[typeOfSpeech].append({word, {}, translations});
+    }
+}
+
+QNetworkReply *QOnlineTranslationJob::requestLibreLangDetection(const QString &text)
+{
+    // Generate POST data
+    const QByteArray postData = "&q=" + QUrl::toPercentEncoding(text)
+        + "&api_key=" + m_libreApiKey;
+
+    // Setup request
+    QNetworkRequest request;
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
+    request.setUrl(m_libreUrl + "/detect");
+
+    // Make reply
+    return m_networkManager->post(request, postData);
+}
+
+void QOnlineTranslationJob::parseLibreLangDetection()
+{
+    m_currentReply->deleteLater();
+
+    // Check for errors
+    if (m_currentReply->error() != QNetworkReply::NoError) {
+        resetData(QOnlineTranslator::NetworkError, m_currentReply->errorString());
+        return;
+    }
+
+    const QJsonDocument jsonResponse = QJsonDocument::fromJson(m_currentReply->readAll());
+    const QJsonObject responseObject = jsonResponse.array().first().toObject();
+
+    if (m_sourceLang == QOnlineTranslator::Auto) {
+        const QString langCode = responseObject.value(QStringLiteral("language")).toString();
+        m_sourceLang = QOnlineTranslator::language(QOnlineTranslator::LibreTranslate, langCode);
+        if (m_sourceLang == QOnlineTranslator::NoLanguage) {
+            resetData(QOnlineTranslator::ParsingError, tr("Error: Unable to parse autodetected language"));
+        }
+    }
+}
+
+QNetworkReply *QOnlineTranslationJob::requestLibreTranslate(const QString &text)
+{
+    // Generate POST data
+    const QByteArray postData = "&q=" + QUrl::toPercentEncoding(text)
+        + "&source=" + QOnlineTranslator::languageApiCode(QOnlineTranslator::LibreTranslate, m_sourceLang).toUtf8()
+        + "&target=" + QOnlineTranslator::languageApiCode(QOnlineTranslator::LibreTranslate, m_translationLang).toUtf8()
+        + "&api_key=" + m_libreApiKey;
+
+    // Setup request
+    QNetworkRequest request;
+    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
+    request.setUrl(m_libreUrl + "/translate");
+
+    // Make reply
+    return m_networkManager->post(request, postData);
+}
+
+void QOnlineTranslationJob::parseLibreTranslate()
+{
+    m_currentReply->deleteLater();
+
+    // Check for errors
+    if (m_currentReply->error() != QNetworkReply::NoError) {
+        resetData(QOnlineTranslator::NetworkError, m_currentReply->errorString());
+        return;
+    }
+
+    const QJsonDocument jsonResponse = QJsonDocument::fromJson(m_currentReply->readAll());
+    const QJsonObject responseObject = jsonResponse.object();
+
+    m_translation += responseObject.value(QStringLiteral("translatedText")).toString();
+}
+
+QNetworkReply *QOnlineTranslationJob::requestLingvaTranslate(const QString &text)
+{
+    // Generate API url
+    QUrl url(m_lingvaUrl + "/api/v1/"
+             + QOnlineTranslator::languageApiCode(QOnlineTranslator::Lingva, m_sourceLang) + "/"
+             + QOnlineTranslator::languageApiCode(QOnlineTranslator::Lingva, m_translationLang) + "/"
+             + QUrl::toPercentEncoding(text));
+
+    return m_networkManager->get(QNetworkRequest(url));
+}
+
+void QOnlineTranslationJob::parseLingvaTranslate()
+{
+    m_currentReply->deleteLater();
+
+    // Check for errors
+    if (m_currentReply->error() != QNetworkReply::NoError) {
+        resetData(QOnlineTranslator::NetworkError, m_currentReply->errorString());
+        return;
+    }
+
+    // Parse translation data
+    const QJsonDocument jsonResponse = QJsonDocument::fromJson(m_currentReply->readAll());
+    const QJsonObject responseObject = jsonResponse.object();
+    const QJsonObject jsonData = responseObject.value(QStringLiteral("info")).toObject();
+
+    // Parse translation itself
+    m_translation = responseObject.value(QStringLiteral("translation")).toString();
+
+    // Parse transliteration, if enabled
+    if (m_translationTranslitEnabled)
+        m_translationTranslit = jsonData.value(QStringLiteral("pronunciation"))
+                                    .toObject()
+                                    .value(QStringLiteral("translation"))
+                                    .toString();
+
+    // Translation options
+    if (m_translationOptionsEnabled) {
+        const QJsonArray translationOptionsData = jsonData.value(QStringLiteral("extraTranslations")).toArray();
+        for (const QJsonValue &typeOfSpeechData : translationOptionsData) {
+            const QJsonObject speechDataObject = typeOfSpeechData.toObject();
+            const QJsonArray typeOfSpeechDataArray = speechDataObject.value(QStringLiteral("list")).toArray();
+            const QString typeOfSpeech = speechDataObject.value(QStringLiteral("type")).toString();
+            for (const QJsonValue &wordData : typeOfSpeechDataArray) {
+                const QJsonObject wordDataObject = wordData.toObject();
+                const QString word = wordDataObject.value(QStringLiteral("word")).toString();
+                const QJsonArray translationsArray = wordDataObject.value(QStringLiteral("meanings")).toArray();
+                QStringList translations;
+                translations.reserve(translationsArray.size());
+                for (const QJsonValue &wordTranslation : translationsArray)
+                    translations.append(wordTranslation.toString());
+                m_translationOptions[typeOfSpeech].append({word, QString(), translations});
+            }
+        }
+    }
+
+    // Examples
+    if (m_examplesEnabled) {
+        const QJsonArray allExamplesData = jsonData.value(QStringLiteral("definitions")).toArray();
+        for (const QJsonValue &examplesData : allExamplesData) {
+            const QJsonObject examplesObject = examplesData.toObject();
+            const QString typeOfSpeech = examplesObject.value(QStringLiteral("type")).toString();
+
+            const QJsonArray examplesArray = examplesObject.value(QStringLiteral("list")).toArray();
+            for (const QJsonValue &exampleData : examplesArray) {
+                const QJsonObject exampleObject = exampleData.toObject();
+                const QString example = exampleObject.value(QStringLiteral("example")).toString();
+                const QString definition = exampleObject.value(QStringLiteral("definition")).toString();
+
+                m_examples[typeOfSpeech].append({example, definition});
+            }
+        }
+    }
+}
+
+void QOnlineTranslationJob::buildGooglePipeline()
+{
+    // Google sends translation, translit and dictionary in one request, that will be splitted into several by the translation limit
+    m_steps.append({&QOnlineTranslationJob::requestGoogleTranslate, &QOnlineTranslationJob::parseGoogleTranslate, &QOnlineTranslationJob::m_source, s_engineChunkSize});
+}
+
+void QOnlineTranslationJob::buildGoogleDetectPipeline()
+{
+    m_steps.append({&QOnlineTranslationJob::requestGoogleTranslate, &QOnlineTranslationJob::parseGoogleTranslate, &QOnlineTranslationJob::m_source, s_engineChunkSize, true});
+}
+
+void QOnlineTranslationJob::buildYandexPipeline()
+{
+    m_steps.append({&QOnlineTranslationJob::requestYandexTranslate, &QOnlineTranslationJob::parseYandexTranslate, &QOnlineTranslationJob::m_source, s_engineChunkSize});
+
+    // Requests for the source text need its language, so they wait for the translation only if it should be detected
+    const int sourceDependency = m_sourceLang == QOnlineTranslator::Auto ? 0 : -1;
+    if (m_sourceTranslitEnabled)
+        m_steps.append({&QOnlineTranslationJob::requestYandexSourceTranslit, &QOnlineTranslationJob::parseYandexSourceTranslit, &QOnlineTranslationJob::m_source, QOnlineTranslator::s_yandexTranslitLimit, false, sourceDependency});
+
+    // Translation text is taken when the step starts, after the translation step
+    if (m_translationTranslitEnabled)
+        m_steps.append({&QOnlineTranslationJob::requestYandexTranslationTranslit, &QOnlineTranslationJob::parseYandexTranslationTranslit, &QOnlineTranslationJob::m_translation, QOnlineTranslator::s_yandexTranslitLimit, false, 0});
+
+    if (m_translationOptionsEnabled && !QOnlineTranslator::isContainsSpace(m_source))
+        m_steps.append({&QOnlineTranslationJob::requestYandexDictionary, &QOnlineTranslationJob::parseYandexDictionary, &QOnlineTranslationJob::m_source, 0, false, sourceDependency});
+}
+
+void QOnlineTranslationJob::buildYandexDetectPipeline()
+{
+    m_steps.append({&QOnlineTranslationJob::requestYandexTranslate, &QOnlineTranslationJob::parseYandexTranslate, &QOnlineTranslationJob::m_source, s_engineChunkSize, true});
+}
+
+void QOnlineTranslationJob::buildBingPipeline()
+{
+    // Generate credentials from web version first to access API (skipped if already available)
+    m_steps.append({&QOnlineTranslationJob::requestBingCredentials, &QOnlineTranslationJob::parseBingCredentials});
+    m_steps.append({&QOnlineTranslationJob::requestBingTranslate, &QOnlineTranslationJob::parseBingTranslate, &QOnlineTranslationJob::m_source, s_engineChunkSize, false, 0});
+
+    // Dictionary does not need credentials, but needs the source language
+    if (m_translationOptionsEnabled && !QOnlineTranslator::isContainsSpace(m_source))
+        m_steps.append({&QOnlineTranslationJob::requestBingDictionary, &QOnlineTranslationJob::parseBingDictionary, &QOnlineTranslationJob::m_source, 0, false, m_sourceLang == QOnlineTranslator::Auto ? 1 : -1});
+}
+
+void QOnlineTranslationJob::buildBingDetectPipeline()
+{
+    m_steps.append({&QOnlineTranslationJob::requestBingCredentials, &QOnlineTranslationJob::parseBingCredentials});
+    m_steps.append({&QOnlineTranslationJob::requestBingTranslate, &QOnlineTranslationJob::parseBingTranslate, &QOnlineTranslationJob::m_source, s_engineChunkSize, true, 0});
+}
+
+void QOnlineTranslationJob::buildLibrePipeline()
+{
+    m_steps.append({&QOnlineTranslationJob::requestLibreLangDetection, &QOnlineTranslationJob::parseLibreLangDetection, &QOnlineTranslationJob::m_source});
+    m_steps.append({&QOnlineTranslationJob::requestLibreTranslate, &QOnlineTranslationJob::parseLibreTranslate, &QOnlineTranslationJob::m_source, s_engineChunkSize, false, 0});
+}
+
+void QOnlineTranslationJob::buildLibreDetectPipeline()
+{
+    m_steps.append({&QOnlineTranslationJob::requestLibreLangDetection, &QOnlineTranslationJob::parseLibreLangDetection, &QOnlineTranslationJob::m_source, s_engineChunkSize, true});
+}
+
+void QOnlineTranslationJob::buildLingvaPipeline()
+{
+    m_steps.append({&QOnlineTranslationJob::requestLingvaTranslate, &QOnlineTranslationJob::parseLingvaTranslate, &QOnlineTranslationJob::m_source, s_engineChunkSize});
+}
+
+void QOnlineTranslationJob::buildLingvaDetectPipeline()
+{
+    m_steps.append({&QOnlineTranslationJob::requestLingvaTranslate, &QOnlineTranslationJob::parseLingvaTranslate, &QOnlineTranslationJob::m_source, s_engineChunkSize, true});
+}
+
+// Start steps whose dependencies are finished, finish the job if all steps are done
+void QOnlineTranslationJob::startSteps()
+{
+    bool finished = true;
+    for (const Step &step : qAsConst(m_steps))
+        finished = finished && step.finished;
+
+    if (finished) {
+        m_steps.clear();
+        if (m_scheduler != nullptr)
+            m_scheduler->reportSuccess(m_engine);
+        storeToCache();
+        m_finishTimer->start();
+        return;
+    }
+
+    for (int i = 0; i < m_steps.size(); ++i) {
+        const Step &step = m_steps.at(i);
+        if (step.started || (step.dependency != -1 && !m_steps.at(step.dependency).finished))
+            continue;
+
+        startStep(i);
+        if (m_steps.isEmpty())
+            return; // Finished or stopped by resetData()
+    }
+}
+
+// Split the text of the step into parts and send them
+void QOnlineTranslationJob::startStep(int stepIndex)
+{
+    Step &step = m_steps[stepIndex];
+    step.started = true;
+    step.chunksText = step.text != nullptr ? this->*step.text : QString();
+    const int textLimit = step.textLimit == s_engineChunkSize ? chunkSize() : step.textLimit;
+    if (textLimit == 0) {
+        step.chunks = {Chunk{{0, step.chunksText.size()}}};
+    } else if (step.firstPartOnly) {
+        step.chunks = {Chunk{QTextSegmenter(step.chunksText, textLimit).next()}};
+    } else {
+        const QVector<QTextSegmenter::Segment> segments = QTextSegmenter::split(step.chunksText, textLimit);
+        step.chunks.reserve(segments.size());
+        for (const QTextSegmenter::Segment &segment : segments)
+            step.chunks.append(Chunk{segment});
+    }
+
+    // Parts are sent concurrently if allowed for the engine, replies will be parsed in the original order
+    sendChunks(stepIndex);
+    parseChunks(stepIndex);
+}
+
+// Send requests for the next parts of the step until the concurrency limit is reached
+void QOnlineTranslationJob::sendChunks(int stepIndex)
+{
+    const int concurrency = m_engineConcurrency.value(m_engine, 1);
+    Step &step = m_steps[stepIndex];
+    while (step.sentChunks < step.chunks.size() && step.sentChunks - step.parsedChunks < concurrency) {
+        const int index = step.sentChunks++;
+        step.chunks[index].queueTime = m_timingsClock.elapsed();
+
+        if (m_scheduler == nullptr)
+            sendChunk(stepIndex, index);
+        else
+            scheduleChunk(stepIndex, index);
+    }
+}
+
+// The scheduler sends the request later from the event loop when the engine budget allows
+void QOnlineTranslationJob::scheduleChunk(int stepIndex, int index)
+{
+    Step &step = m_steps[stepIndex];
+    step.chunks[index].scheduled = true;
+    const auto isCurrent = [this, stepIndex, generation = m_chunksGeneration, stepGeneration = step.generation] {
+        return generation == m_chunksGeneration && m_steps.at(stepIndex).generation == stepGeneration;
+    };
+
+    // The request deadline includes the wait, so a long backoff fails the translation immediately
+    const int timeout = m_engineTimeouts.value(m_engine, QOnlineTranslator::s_defaultTimeout);
+    m_scheduler->schedule(
+        m_engine,
+        this,
+        [this, stepIndex, index, isCurrent]() -> QNetworkReply * {
+            if (!isCurrent())
+                return nullptr;
+
+            QNetworkReply *reply = sendChunk(stepIndex, index);
+            if (reply == nullptr)
+                parseChunks(stepIndex); // Nothing to request, continue with the next parts
+            return reply;
+        },
+        timeout,
+        [this, isCurrent] {
+            if (isCurrent())
+                resetData(QOnlineTranslator::NetworkError, tr("Error: Request timed out"));
+        });
+}
+
+QNetworkReply *QOnlineTranslationJob::sendChunk(int stepIndex, int index)
+{
+    Step &step = m_steps[stepIndex];
+    Chunk &chunk = step.chunks[index];
+    chunk.scheduled = false;
+    chunk.sendTime = m_timingsClock.elapsed();
+    chunk.reply = (this->*step.requestMethod)(step.chunksText.mid(chunk.segment.offset, chunk.segment.length));
+    if (chunk.reply != nullptr) {
+        // Should be connected first to finish the timing before parsing
+        if (m_timingsEnabled)
+            startTiming(stepIndex, index);
+        startDeadlines(chunk.reply, chunk.sendTime - chunk.queueTime);
+        connect(chunk.reply, &QNetworkReply::finished, this, [this, stepIndex] {
+            parseChunks(stepIndex);
+        });
+    }
+    return chunk.reply;
+}
+
+// QNetworkReply does not provide timings, so phases are recorded from its signals
+void QOnlineTranslationJob::startTiming(int stepIndex, int index)
+{
+    Chunk &chunk = m_steps[stepIndex].chunks[index];
+    const qint64 sendTime = m_timingsClock.elapsed();
+    const int timingIndex = m_timings.size();
+    chunk.timing = timingIndex;
+
+    QRequestTiming timing;
+    timing.url = chunk.reply->url().toString(QUrl::RemoveQuery);
+    timing.part = index;
+    timing.queued = sendTime - chunk.queueTime;
+    m_timings.append(timing);
+
+    // Emitted only for new connections
+    connect(chunk.reply, &QNetworkReply::encrypted, this, [this, timingIndex, sendTime] {
+        m_timings[timingIndex].connection = m_timingsClock.elapsed() - sendTime;
+    });
+    connect(chunk.reply, &QNetworkReply::metaDataChanged, this, [this, timingIndex, sendTime] {
+        QRequestTiming &timing = m_timings[timingIndex];
+        if (timing.firstByte == -1)
+            timing.firstByte = m_timingsClock.elapsed() - sendTime;
+    });
+    connect(chunk.reply, &QNetworkReply::downloadProgress, this, [this, timingIndex](qint64 bytesReceived) {
+        m_timings[timingIndex].size = bytesReceived;
+    });
+    connect(chunk.reply, &QNetworkReply::finished, this, [this, timingIndex, sendTime] {
+        QRequestTiming &timing = m_timings[timingIndex];
+        if (timing.firstByte != -1)
+            timing.download = m_timingsClock.elapsed() - sendTime - timing.firstByte;
+    });
+}
+
+// Parse finished replies of the step strictly in the source order to stitch the results like sequential requests do
+void QOnlineTranslationJob::parseChunks(int stepIndex)
+{
+    Step &step = m_steps[stepIndex];
+    if (step.finished)
+        return;
+
+    while (step.parsedChunks < step.sentChunks) {
+        const Chunk &chunk = step.chunks.at(step.parsedChunks);
+        if (chunk.scheduled)
+            return;
+
+        if (chunk.reply != nullptr) {
+            if (!chunk.reply->isFinished())
+                return;
+
+            if (step.textLimit == s_engineChunkSize) {
+                tuneChunkSize(chunk);
+                if (splitRejectedChunk(stepIndex, step.parsedChunks))
+                    return;
+            }
+
+            if (retryChunk(stepIndex, step.parsedChunks))
+                return;
+
+            if (chunk.reply->property(s_timedOutProperty).toBool()) {
+                resetData(QOnlineTranslator::NetworkError, tr("Error: Request timed out"));
+                return;
+            }
+
+            m_currentReply = chunk.reply;
+            const int timing = chunk.timing;
+            const int translationSize = m_translation.size();
+            QElapsedTimer parseTimer;
+            parseTimer.start();
+            (this->*step.parseMethod)();
+            if (timing != -1)
+                m_timings[timing].parsing = parseTimer.elapsed();
+
+            if (m_bingRetryPending) {
+                m_bingRetryPending = false;
+                renewBingCredentials(stepIndex, step.parsedChunks);
+                return;
+            }
+
+            // Show translated parts without waiting for the rest of the text and other steps
+            if (m_translation.size() > translationSize)
+                emit partialTranslationAvailable(translationSize, m_translation.mid(translationSize));
+
+            if (m_steps.isEmpty())
+                return; // Stopped by resetData() or aborted from the slot
+        }
+
+        ++step.parsedChunks;
+        sendChunks(stepIndex);
+    }
+
+    if (step.parsedChunks == step.chunks.size()) {
+        step.finished = true;
+        startSteps();
+    }
+}
+
+// Send an idempotent request again after a network failure, the part keeps its place in the parsing order
+bool QOnlineTranslationJob::retryChunk(int stepIndex, int index)
+{
+    Chunk &chunk = m_steps[stepIndex].chunks[index];
+    if (chunk.retries >= m_maxRetries || chunk.reply->operation() != QNetworkAccessManager::GetOperation || !isTransientFailure(chunk.reply))
+        return false;
+
+    chunk.reply->deleteLater();
+    chunk.reply = nullptr;
+    chunk.scheduled = true;
+    ++chunk.retries;
+    ++m_retryCount;
+
+    // Exponential backoff with equal jitter, so parts that failed together do not retry together
+    const int backoff = s_retryDelay << (chunk.retries - 1);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+    const int jitter = QRandomGenerator::global()->bounded(backoff / 2 + 1);
+#else
+    const int jitter = qrand() % (backoff / 2 + 1);
+#endif
+    QTimer::singleShot(backoff / 2 + jitter, this, [this, stepIndex, index, generation = m_chunksGeneration, stepGeneration = m_steps.at(stepIndex).generation] {
+        if (generation == m_chunksGeneration && m_steps.at(stepIndex).generation == stepGeneration)
+            resendChunk(stepIndex, index);
+    });
+    return true;
+}
+
+// Split the rest of the step text again if the engine rejected the part as too large, the text keeps its order
+bool QOnlineTranslationJob::splitRejectedChunk(int stepIndex, int index)
+{
+    Step &step = m_steps[stepIndex];
+    const Chunk &chunk = step.chunks.at(index);
+
+    // Payload Too Large or URI Too Long
+    const int status = chunk.reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status != 413 && status != 414)
+        return false;
+
+    // Use the tuned size if it was shrunk enough, the part is reported as an error if it can't be smaller
+    const int size = qMin(chunkSize(), qMax(s_minChunkSize, chunk.segment.length / 2));
+    if (size >= chunk.segment.length)
+        return false;
+
+    // Later parts were split by the same size and will be rejected too
+    for (int i = index; i < step.chunks.size(); ++i) {
+        const Chunk &rejectedChunk = step.chunks.at(i);
+        if (rejectedChunk.reply != nullptr) {
+            rejectedChunk.reply->disconnect(this);
+            rejectedChunk.reply->abort();
+            rejectedChunk.reply->deleteLater();
+        }
+    }
+
+    const int offset = chunk.segment.offset;
+    const QString text = step.chunksText.mid(offset, step.firstPartOnly ? chunk.segment.length : -1);
+    step.chunks.resize(index);
+    if (step.firstPartOnly) {
+        const QTextSegmenter::Segment segment = QTextSegmenter(text, size).next();
+        step.chunks.append(Chunk{{offset + segment.offset, segment.length}});
+    } else {
+        for (const QTextSegmenter::Segment &segment : QTextSegmenter::split(text, size))
+            step.chunks.append(Chunk{{offset + segment.offset, segment.length}});
+    }
+    step.sentChunks = index;
+    ++step.generation;
+
+    sendChunks(stepIndex);
+    return true;
+}
+
+// Send the part again, it keeps its place in the parsing order
+void QOnlineTranslationJob::resendChunk(int stepIndex, int index)
+{
+    m_steps[stepIndex].chunks[index].queueTime = m_timingsClock.elapsed();
+    if (m_scheduler != nullptr) {
+        scheduleChunk(stepIndex, index);
+        return;
+    }
+
+    sendChunk(stepIndex, index);
+    parseChunks(stepIndex);
+}
+
+// Request new credentials and send only the rejected part again, other steps and jobs waiting for the results continue
+void QOnlineTranslationJob::renewBingCredentials(int stepIndex, int index)
+{
+    Chunk &chunk = m_steps[stepIndex].chunks[index];
+
+    // Credentials received after the request was sent were rejected too
+    if (m_bingCredentialsTime != -1 && chunk.sendTime >= m_bingCredentialsTime) {
+        resetData(QOnlineTranslator::NetworkError, tr("Error: Bing rejected the credentials"));
+        return;
+    }
+
+    chunk.reply = nullptr;
+    chunk.scheduled = true;
+
+    // Parts sent together with the rejected one reuse credentials that were already renewed
+    if (m_bingCredentialsTime != -1) {
+        resendChunk(stepIndex, index);
+        return;
+    }
+
+    clearBingCredentials();
+    m_bingCredentialsReply = requestBingCredentials({});
+    if (m_bingCredentialsReply == nullptr) {
+        // Renewed by another job
+        m_bingCredentialsTime = m_timingsClock.elapsed();
+        resendChunk(stepIndex, index);
+        return;
+    }
+
+    startDeadlines(m_bingCredentialsReply);
+    connect(m_bingCredentialsReply, &QNetworkReply::finished, this, [this, stepIndex, index, reply = m_bingCredentialsReply.data()] {
+        m_bingCredentialsReply = nullptr;
+        m_currentReply = reply;
+        parseBingCredentials();
+        if (!m_steps.isEmpty())
+            resendChunk(stepIndex, index);
+    });
+}
+
+void QOnlineTranslationJob::abortChunks()
+{
+    QVector<Chunk> chunks;
+    for (Step &step : m_steps) {
+        chunks += std::exchange(step.chunks, {});
+        step.sentChunks = 0;
+        step.parsedChunks = 0;
+    }
+    ++m_chunksGeneration;
+
+    if (m_bingCredentialsReply != nullptr) {
+        m_bingCredentialsReply->disconnect(this);
+        m_bingCredentialsReply->abort();
+        m_bingCredentialsReply->deleteLater();
+        m_bingCredentialsReply = nullptr;
+    }
+
+    for (const Chunk &chunk : qAsConst(chunks)) {
+        if (chunk.reply != nullptr) {
+            chunk.reply->disconnect(this);
+            chunk.reply->abort();
+            chunk.reply->deleteLater();
+        }
+    }
+}
+
+// QNetworkRequest timeouts are not available in all supported Qt versions, so replies are aborted by timers
+void QOnlineTranslationJob::startDeadlines(QNetworkReply *reply, qint64 queued) const
+{
+    const auto abortReply = [reply] {
+        reply->setProperty(s_timedOutProperty, true);
+        reply->abort();
+    };
+
+    // Headers arrive after connecting and processing of the request, so it covers both
+    if (const int responseTimeout = m_engineResponseTimeouts.value(m_engine, QOnlineTranslator::s_defaultResponseTimeout); responseTimeout > 0) {
+        auto *responseTimer = new QTimer(reply);
+        responseTimer->setSingleShot(true);
+        connect(responseTimer, &QTimer::timeout, reply, abortReply);
+        connect(reply, &QNetworkReply::metaDataChanged, responseTimer, &QTimer::stop);
+        responseTimer->start(responseTimeout);
+    }
+
+    // The whole request time starts when it was queued for sending
+    if (const int timeout = m_engineTimeouts.value(m_engine, QOnlineTranslator::s_defaultTimeout); timeout > 0) {
+        auto *timer = new QTimer(reply);
+        timer->setSingleShot(true);
+        connect(timer, &QTimer::timeout, reply, abortReply);
+        timer->start(static_cast<int>(qMax<qint64>(1, timeout - queued)));
+    }
+}
+
+// Failures that may disappear on the next attempt, errors of the engine are not retried
+bool QOnlineTranslationJob::isTransientFailure(const QNetworkReply *reply)
+{
+    if (reply->property(s_timedOutProperty).toBool())
+        return true;
+
+    switch (reply->error()) {
+    case QNetworkReply::ConnectionRefusedError:
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::HostNotFoundError:
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+    case QNetworkReply::UnknownNetworkError:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Fail immediately instead of waiting for timeouts if the system reports no connectivity
+bool QOnlineTranslationJob::isOffline()
+{
+#if QT_VERSION >= QT_VERSION_CHECK(6, 1, 0)
+    // Reachability is unknown if there is no backend for the platform
+    if (QNetworkInformation::instance() == nullptr && !QNetworkInformation::load(QNetworkInformation::Feature::Reachability))
+        return false;
+
+    return QNetworkInformation::instance()->reachability() == QNetworkInformation::Reachability::Disconnected;
+#elif QT_VERSION < QT_VERSION_CHECK(6, 0, 0)
+    // Reachability is unknown if there are no bearer plugins, since there are no configurations at all
+    QT_WARNING_PUSH
+    QT_WARNING_DISABLE_DEPRECATED
+    const QNetworkConfigurationManager manager;
+    const bool offline = !manager.allConfigurations().isEmpty() && !manager.isOnline();
+    QT_WARNING_POP
+    return offline;
+#else
+    return false;
+#endif
+}
+
+// Chunk size of the current engine, tuned by previous requests if enabled
+int QOnlineTranslationJob::chunkSize() const
+{
+    if (m_chunkSizeTuningEnabled && m_translator != nullptr) {
+        const int tunedSize = m_translator->m_chunkSizeTuning.value(m_engine).size;
+        if (tunedSize != 0)
+            return tunedSize;
+    }
+
+    return m_engineChunkSizes.value(m_engine, QOnlineTranslator::defaultChunkSize(m_engine));
+}
+
+// Grow the size while the response time per character does not increase, shrink it on slow or rejected requests
+void QOnlineTranslationJob::tuneChunkSize(const Chunk &chunk)
+{
+    if (!m_chunkSizeTuningEnabled || m_translator == nullptr)
+        return;
+
+    const int initialSize = m_engineChunkSizes.value(m_engine, QOnlineTranslator::defaultChunkSize(m_engine));
+    const int maxSize = qMin(s_maxChunkSize, initialSize * s_maxChunkSizeGrowth);
+    QOnlineTranslator::ChunkSizeTuning &tuning = m_translator->m_chunkSizeTuning[m_engine];
+    if (tuning.size == 0)
+        tuning.size = initialSize;
+
+    // Payload Too Large or URI Too Long
+    const int status = chunk.reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    if (status == 413 || status == 414) {
+        tuning.size = qMax(s_minChunkSize, qMin(tuning.size, chunk.segment.length) / 2);
+        tuning.latency = 0;
+        return;
+    }
+
+    if (chunk.reply->property(s_timedOutProperty).toBool()) {
+        tuning.size = qMax(s_minChunkSize, tuning.size - tuning.size / 4);
+        return;
+    }
+
+    // Only full parts show how the engine handles the current size
+    if (chunk.reply->error() != QNetworkReply::NoError || chunk.segment.length < tuning.size * 3 / 4)
+        return;
+
+    const double latency = static_cast<double>(m_timingsClock.elapsed() - chunk.sendTime) / chunk.segment.length;
+    if (tuning.latency == 0 || latency <= tuning.latency * s_chunkLatencyTolerance)
+        tuning.size = qMin(maxSize, tuning.size + tuning.size / 4);
+    else if (latency > tuning.latency * s_chunkLatencyTolerance * s_chunkLatencyTolerance)
+        tuning.size = qMax(s_minChunkSize, tuning.size - tuning.size / 4);
+
+    // Exponential moving average to smooth out network jitter
+    tuning.latency = tuning.latency == 0 ? latency : tuning.latency * 0.75 + latency * 0.25;
+}
+
+// Custom URL replaces the default host, e.g. to use a proxy or a local server
+QString QOnlineTranslationJob::engineUrl(const QString &customUrl, const QString &defaultUrl)
+{
+    return customUrl.isEmpty() ? defaultUrl : customUrl;
+}
+
+QString QOnlineTranslationJob::cacheKey(const QString &source) const
+{
+    const QByteArray sourceHash = QCryptographicHash::hash(source.normalized(QString::NormalizationForm_C).toUtf8(), QCryptographicHash::Sha1).toHex();
+    return contextKey() + '/' + sourceHash;
+}
+
+QString QOnlineTranslationJob::contextKey() const
+{
+    // Results from different instances may differ
+    QString engineUrl;
+    switch (m_engine) {
+    case QOnlineTranslator::Google:
+        engineUrl = m_googleUrl;
+        break;
+    case QOnlineTranslator::Yandex:
+        engineUrl = m_yandexUrl;
+        break;
+    case QOnlineTranslator::Bing:
+        engineUrl = m_bingUrl;
+        break;
+    case QOnlineTranslator::LibreTranslate:
+        engineUrl = m_libreUrl;
+        break;
+    case QOnlineTranslator::Lingva:
+        engineUrl = m_lingvaUrl;
+        break;
+    }
+
+    const QString features = QString::number(m_sourceTranslitEnabled)
+        + QString::number(m_translationTranslitEnabled)
+        + QString::number(m_sourceTranscriptionEnabled)
+        + QString::number(m_translationOptionsEnabled)
+        + QString::number(m_examplesEnabled);
+
+    const QStringList keyParts{
+        QMetaEnum::fromType<QOnlineTranslator::Engine>().valueToKey(m_engine),
+        engineUrl,
+        QOnlineTranslator::languageCode(m_requestedSourceLang),
+        QOnlineTranslator::languageCode(m_translationLang),
+        QOnlineTranslator::languageCode(m_uiLang),
+        features,
+    };
+    return keyParts.join('/');
+}
+
+bool QOnlineTranslationJob::loadFromCache()
+{
+    QOnlineTranslationCache::Entry entry;
+    if (m_cache == nullptr || !m_cache->find(m_cacheKey, entry))
+        return false;
+
+    m_sourceLang = entry.sourceLang;
+    m_translation = qMove(entry.translation);
+    m_translationTranslit = qMove(entry.translationTranslit);
+    m_sourceTranslit = qMove(entry.sourceTranslit);
+    m_sourceTranscription = qMove(entry.sourceTranscription);
+    m_translationOptions = qMove(entry.translationOptions);
+    m_examples = qMove(entry.examples);
+    return true;
+}
+
+void QOnlineTranslationJob::storeToCache()
+{
+    if (m_cache == nullptr || m_cacheKey.isEmpty() || m_error != QOnlineTranslator::NoError)
+        return;
+
+    QOnlineTranslationCache::Entry entry;
+    entry.sourceLang = m_sourceLang;
+    entry.translation = m_translation;
+    entry.translationTranslit = m_translationTranslit;
+    entry.sourceTranslit = m_sourceTranslit;
+    entry.sourceTranscription = m_sourceTranscription;
+    entry.translationOptions = m_translationOptions;
+    entry.examples = m_examples;
+    m_cache->insert(m_cacheKey, entry);
+}
+
+bool QOnlineTranslationJob::joinRunningTranslation()
+{
+    QOnlineTranslationJob *leader = s_runningTranslations.value(m_cacheKey);
+    if (leader == nullptr || leader == this) {
+        s_runningTranslations.insert(m_cacheKey, this);
+        return false;
+    }
+
+    m_leader = leader;
+    leader->m_followers.append(this);
+    return true;
+}
+
+void QOnlineTranslationJob::leaveRunningTranslation()
+{
+    if (m_leader != nullptr) {
+        m_leader->m_followers.removeOne(this);
+        m_leader = nullptr;
+        return;
+    }
+
+    if (s_runningTranslations.value(m_cacheKey) == this)
+        s_runningTranslations.remove(m_cacheKey);
+
+    // The first follower will send requests and the rest will wait for it
+    const QVector<QOnlineTranslationJob *> followers = std::exchange(m_followers, {});
+    for (QOnlineTranslationJob *follower : followers) {
+        follower->m_leader = nullptr;
+        follower->retranslate();
+    }
+}
+
+void QOnlineTranslationJob::shareResults()
+{
+    if (s_runningTranslations.value(m_cacheKey) == this)
+        s_runningTranslations.remove(m_cacheKey);
+
+    const QVector<QOnlineTranslationJob *> followers = std::exchange(m_followers, {});
+    for (QOnlineTranslationJob *follower : followers) {
+        follower->m_leader = nullptr;
+        follower->copyResults(this);
+        follower->m_finishTimer->start();
+    }
+}
+
+void QOnlineTranslationJob::copyResults(const QOnlineTranslationJob *job)
+{
+    m_engine = job->m_engine;
+    m_sourceLang = job->m_sourceLang;
+    m_translation = job->m_translation;
+    m_translationTranslit = job->m_translationTranslit;
+    m_sourceTranslit = job->m_sourceTranslit;
+    m_sourceTranscription = job->m_sourceTranscription;
+    m_translationOptions = job->m_translationOptions;
+    m_examples = job->m_examples;
+    m_timings = job->m_timings;
+    m_retryCount = job->m_retryCount;
+    m_error = job->m_error;
+    m_errorString = job->m_errorString;
+}
+
+// Request the same translation from the hedging engine, the first successful result will be used
+void QOnlineTranslationJob::startHedging()
+{
+    if (m_translator == nullptr) {
+        // Report the error of the main engine if it has already failed
+        if (!isRunning())
+            m_finishTimer->start();
+        return;
+    }
+
+    m_hedgingJob = new QOnlineTranslationJob(m_translator);
+    m_hedgingJob->setParent(this);
+    m_hedgingJob->m_hedgingDelay = 0;
+    connect(m_hedgingJob, &QOnlineTranslationJob::finished, this, &QOnlineTranslationJob::finishHedging);
+    m_hedgingJob->translate(m_source, m_hedgingEngine, m_translationLang, m_requestedSourceLang, m_uiLang);
+}
+
+void QOnlineTranslationJob::finishHedging()
+{
+    QOnlineTranslationJob *hedgingJob = m_hedgingJob;
+    m_hedgingJob = nullptr;
+    hedgingJob->deleteLater();
+
+    if (hedgingJob->m_error != QOnlineTranslator::NoError) {
+        // Report the error of the main engine if it has already failed
+        if (!isRunning())
+            m_finishTimer->start();
+        return;
+    }
+
+    // Stop requests of the main engine and use the hedging results instead
+    if (m_leader != nullptr)
+        leaveRunningTranslation();
+    m_bingRetryPending = false;
+    resetData();
+    copyResults(hedgingJob);
+    m_finishTimer->start();
+}
+
+void QOnlineTranslationJob::abortHedging()
+{
+    m_hedgingTimer->stop();
+    if (m_hedgingJob != nullptr) {
+        m_hedgingJob->disconnect(this);
+        m_hedgingJob->abort();
+        m_hedgingJob->deleteLater();
+        m_hedgingJob = nullptr;
+    }
+}
+
+// Translate groups of sentences separately, so unchanged groups of an edited text will be taken from the cache
+bool QOnlineTranslationJob::translateSegments()
+{
+    if (!m_incrementalTranslationEnabled || m_cache == nullptr || m_translator == nullptr)
+        return false;
+
+    m_segments = sentenceGroups(m_source);
+    if (m_segments.size() < 2) {
+        m_segments.clear();
+        return false;
+    }
+
+    // Each missing group costs a separate request, so translate the text as a whole (with the context of all sentences)
+    // unless most groups are cached. Groups are translated with the same settings, so a group is also cached
+    // when it was translated as a whole text before
+    int cachedGroups = 0;
+    for (const QTextSegmenter::Segment &segment : qAsConst(m_segments)) {
+        QOnlineTranslationCache::Entry entry;
+        if (m_cache->find(cacheKey(m_source.mid(segment.offset, segment.length)), entry))
+            ++cachedGroups;
+    }
+    if (cachedGroups * 2 < m_segments.size()) {
+        m_segments.clear();
+        return false;
+    }
+
+    m_segmentJobs.resize(m_segments.size());
+    m_translation = m_source.left(m_segments.constFirst().offset);
+    startSegments();
+    return true;
+}
+
+// Translate next groups until the engine concurrency limit is reached, cached groups finish without requests.
+// If the source language is unknown, it's detected by the first group and used for others
+void QOnlineTranslationJob::startSegments()
+{
+    const int concurrency = m_sourceLang == QOnlineTranslator::Auto ? 1 : m_engineConcurrency.value(m_engine, 1);
+    while (m_startedSegments < m_segments.size() && m_runningSegments < concurrency && m_translator != nullptr) {
+        const int index = m_startedSegments++;
+        const QTextSegmenter::Segment &segment = m_segments.at(index);
+
+        auto *job = new QOnlineTranslationJob(m_translator);
+        job->setParent(this);
+        job->m_hedgingDelay = 0;
+        job->m_incrementalTranslationEnabled = false;
+        job->m_sourceTranslitEnabled = m_sourceTranslitEnabled;
+        job->m_translationTranslitEnabled = m_translationTranslitEnabled;
+        job->m_sourceTranscriptionEnabled = m_sourceTranscriptionEnabled;
+        job->m_translationOptionsEnabled = m_translationOptionsEnabled;
+        job->m_examplesEnabled = m_examplesEnabled;
+        job->m_timingsEnabled = m_timingsEnabled;
+        job->m_maxRetries = m_maxRetries;
+        job->m_chunkSizeTuningEnabled = m_chunkSizeTuningEnabled;
+        m_segmentJobs[index] = job;
+        ++m_runningSegments;
+
+        connect(job, &QOnlineTranslationJob::finished, this, [this, index] {
+            finishSegment(index);
+        });
+        connect(job, &QOnlineTranslationJob::partialTranslationAvailable, this, [this, index](int, const QString &text) {
+            // Parts of next groups are shown after previous groups are finished
+            if (index != m_shownSegments)
+                return;
+
+            m_translation += text;
+            m_shownSegmentSize += text.size();
+            emitPartialTranslation();
+        });
+        job->translate(m_source.mid(segment.offset, segment.length), m_engine, m_translationLang, m_sourceLang, m_uiLang);
+    }
+}
+
+void QOnlineTranslationJob::finishSegment(int index)
+{
+    --m_runningSegments;
+
+    const QOnlineTranslationJob *job = m_segmentJobs.at(index);
+    if (job->m_error != QOnlineTranslator::NoError) {
+        // The segment job has already reported the error to the scheduler
+        const QOnlineTranslator::TranslationError error = job->m_error;
+        const QString errorString = job->m_errorString;
+        resetData();
+        m_error = error;
+        m_errorString = errorString;
+        m_finishTimer->start();
+        return;
+    }
+
+    if (m_sourceLang == QOnlineTranslator::Auto)
+        m_sourceLang = job->m_sourceLang;
+
+    showSegments();
+    if (m_segmentJobs.isEmpty())
+        return; // Aborted from the slot
+
+    if (m_runningSegments != 0 || m_startedSegments != m_segments.size()) {
+        startSegments();
+        return;
+    }
+
+    // The translation is already stitched by showSegments()
+    for (const QOnlineTranslationJob *segmentJob : qAsConst(m_segmentJobs)) {
+        QOnlineTranslator::addSpaceBetweenParts(m_translationTranslit);
+        m_translationTranslit += segmentJob->m_translationTranslit;
+        QOnlineTranslator::addSpaceBetweenParts(m_sourceTranslit);
+        m_sourceTranslit += segmentJob->m_sourceTranslit;
+        QOnlineTranslator::addSpaceBetweenParts(m_sourceTranscription);
+        m_sourceTranscription += segmentJob->m_sourceTranscription;
+        for (auto it = segmentJob->m_translationOptions.cbegin(); it != segmentJob->m_translationOptions.cend(); ++it)
+            m_translationOptions[it.key()] += it.value();
+        for (auto it = segmentJob->m_examples.cbegin(); it != segmentJob->m_examples.cend(); ++it)
+            m_examples[it.key()] += it.value();
+        m_timings += segmentJob->m_timings;
+        m_retryCount += segmentJob->m_retryCount;
+    }
+
+    // Groups are cached by their jobs, the whole text is cached too to be taken at once next time
+    abortSegments();
+    storeToCache();
+    m_finishTimer->start();
+}
+
+// Append translations of finished groups in their order, keeping the original spaces between groups
+void QOnlineTranslationJob::showSegments()
+{
+    while (m_shownSegments < m_segmentJobs.size()) {
+        const QOnlineTranslationJob *job = m_segmentJobs.at(m_shownSegments);
+        if (job == nullptr || job->isRunning())
+            break;
+
+        const QTextSegmenter::Segment &segment = m_segments.at(m_shownSegments);
+        const int segmentEnd = segment.offset + segment.length;
+        const int nextOffset = m_shownSegments + 1 < m_segments.size() ? m_segments.at(m_shownSegments + 1).offset : m_source.size();
+        m_translation += job->m_translation.midRef(m_shownSegmentSize);
+        m_translation += m_source.midRef(segmentEnd, nextOffset - segmentEnd);
+        m_shownSegmentSize = 0;
+        ++m_shownSegments;
+    }
+
+    emitPartialTranslation();
+}
+
+void QOnlineTranslationJob::emitPartialTranslation()
+{
+    if (m_translation.size() <= m_shownTranslationSize)
+        return;
+
+    const int offset = std::exchange(m_shownTranslationSize, m_translation.size());
+    emit partialTranslationAvailable(offset, m_translation.mid(offset));
+}
+
+void QOnlineTranslationJob::abortSegments()
+{
+    const QVector<QOnlineTranslationJob *> jobs = std::exchange(m_segmentJobs, {});
+    m_segments.clear();
+    m_startedSegments = 0;
+    m_runningSegments = 0;
+    m_shownSegments = 0;
+    m_shownSegmentSize = 0;
+    m_shownTranslationSize = 0;
+
+    for (QOnlineTranslationJob *job : jobs) {
+        if (job != nullptr) {
+            job->disconnect(this);
+            job->abort();
+            job->deleteLater();
+        }
+    }
+}
+
+// Groups end after sentences chosen by their content instead of positions, so an edit changes only the group around it
+QVector<QTextSegmenter::Segment> QOnlineTranslationJob::sentenceGroups(const QString &text)
+{
+    QVector<QTextSegmenter::Segment> groups;
+    int groupBegin = -1;
+    int groupEnd = 0;
+    int sentenceBegin = 0;
+
+    QTextBoundaryFinder finder(QTextBoundaryFinder::Sentence, text);
+    while (finder.toNextBoundary() != -1) {
+        const QStringRef sentence = text.midRef(sentenceBegin, finder.position() - sentenceBegin).trimmed();
+        sentenceBegin = finder.position();
+        if (sentence.isEmpty())
+            continue;
+
+        if (groupBegin == -1)
+            groupBegin = sentence.position();
+        groupEnd = sentence.position() + sentence.size();
+
+        if (qHash(sentence) % s_segmentSentences == 0 || groupEnd - groupBegin >= s_maxSegmentLength) {
+            groups.append({groupBegin, groupEnd - groupBegin});
+            groupBegin = -1;
+        }
+    }
+
+    if (groupBegin != -1)
+        groups.append({groupBegin, groupEnd - groupBegin});
+
+    return groups;
+}
+
+QNetworkReply *QOnlineTranslationJob::requestYandexTranslit(QOnlineTranslator::Language language, const QString &text)
+{
+    // Check if language is supported (need to check here because language may be autodetected)
+    if (!QOnlineTranslator::isSupportTranslit(QOnlineTranslator::Yandex, language))
+        return nullptr;
+
+    // Generate API url
+    QUrl url(engineUrl(m_yandexUrl, QStringLiteral("https://translate.yandex.net")) + "/translit/translit");
+    url.setQuery("text=" + QUrl::toPercentEncoding(text)
+                 + "&lang=" + QOnlineTranslator::languageApiCode(QOnlineTranslator::Yandex, language));
+
+    return m_networkManager->get(QNetworkRequest(url));
+}
+
+void QOnlineTranslationJob::parseYandexTranslit(QString &text)
+{
+    m_currentReply->deleteLater();
+
+    if (m_currentReply->error() != QNetworkReply::NoError) {
+        resetData(QOnlineTranslator::NetworkError, m_currentReply->errorString());
+        return;
+    }
+
+    const QByteArray reply = m_currentReply->readAll();
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+    text += reply.mid(1).chopped(1);
+#else
+    text += reply.mid(1);
+    text.chop(1);
+#endif
+}
+
+// Aho-Corasick automaton with precomputed transitions to find all Bing markers in one pass
+const QOnlineTranslationJob::BingMarkersAutomaton &QOnlineTranslationJob::bingMarkersAutomaton()
+{
+    static const BingMarkersAutomaton automaton = [] {
+        BingMarkersAutomaton result;
+        result.transitions.fill(-1, 256);
+        result.matches.append(-1);
+
+        // Trie of markers
+        for (int marker = 0; marker < BingMarkersCount; ++marker) {
+            int state = 0;
+            for (const char *symbol = s_bingMarkers[marker]; *symbol != '\0'; ++symbol) {
+                const int transition = state * 256 + static_cast<uchar>(*symbol);
+                if (result.transitions.at(transition) == -1) {
+                    result.transitions[transition] = result.matches.size();
+                    result.transitions.append(QVector<int>(256, -1));
+                    result.matches.append(-1);
+                }
+                state = result.transitions.at(transition);
+            }
+            result.matches[state] = marker;
+        }
+
+        // Replace missing transitions with transitions of the longest suffix state (breadth-first)
+        QVector<int> suffixStates(result.matches.size(), 0);
+        QQueue<int> states;
+        for (int symbol = 0; symbol < 256; ++symbol) {
+            if (result.transitions.at(symbol) == -1)
+                result.transitions[symbol] = 0;
+            else
+                states.enqueue(result.transitions.at(symbol));
+        }
+        while (!states.isEmpty()) {
+            const int state = states.dequeue();
+            const int suffixState = suffixStates.at(state);
+            if (result.matches.at(state) == -1)
+                result.matches[state] = result.matches.at(suffixState);
+
+            for (int symbol = 0; symbol < 256; ++symbol) {
+                const int transition = state * 256 + symbol;
+                const int suffixTransition = result.transitions.at(suffixState * 256 + symbol);
+                if (result.transitions.at(transition) == -1) {
+                    result.transitions[transition] = suffixTransition;
+                } else {
+                    suffixStates[result.transitions.at(transition)] = suffixTransition;
+                    states.enqueue(result.transitions.at(transition));
+                }
+            }
+        }
+
+        return result;
+    }();
+
+    return automaton;
+}
+
+// Load credentials from previous runs if they are not loaded yet, returns `true` if they are valid
+bool QOnlineTranslationJob::loadBingCredentials()
+{
+    QMutexLocker locker(&QOnlineTranslator::s_bingCredentialsMutex);
+    if (QOnlineTranslator::s_bingKey.isEmpty()) {
+        QFile file(bingCredentialsPath());
+        if (file.open(QFile::ReadOnly)) {
+            const QJsonObject object = QJsonDocument::fromJson(file.readAll()).object();
+            QOnlineTranslator::s_bingKey = object.value(QStringLiteral("key")).toString().toUtf8();
+            QOnlineTranslator::s_bingToken = object.value(QStringLiteral("token")).toString().toUtf8();
+            QOnlineTranslator::s_bingIg = object.value(QStringLiteral("ig")).toString();
+            QOnlineTranslator::s_bingIid = object.value(QStringLiteral("iid")).toString();
+            QOnlineTranslator::s_bingExpiration = QDateTime::fromString(object.value(QStringLiteral("expires")).toString(), Qt::ISODate);
+        }
+    }
+
+    return !QOnlineTranslator::s_bingKey.isEmpty()
+        && !QOnlineTranslator::s_bingToken.isEmpty()
+        && QOnlineTranslator::s_bingExpiration > QDateTime::currentDateTimeUtc();
+}
+
+void QOnlineTranslationJob::saveBingCredentials()
+{
+    const QString path = bingCredentialsPath();
+    if (!QDir().mkpath(QFileInfo(path).path()))
+        return;
+
+    QMutexLocker locker(&QOnlineTranslator::s_bingCredentialsMutex);
+    const QJsonObject object{
+        {"expires", QOnlineTranslator::s_bingExpiration.toString(Qt::ISODate)},
+        {"ig", QOnlineTranslator::s_bingIg},
+        {"iid", QOnlineTranslator::s_bingIid},
+        {"issued", QDateTime::currentDateTimeUtc().toString(Qt::ISODate)},
+        {"key", QString::fromUtf8(QOnlineTranslator::s_bingKey)},
+        {"token", QString::fromUtf8(QOnlineTranslator::s_bingToken)},
+    };
+
+    QSaveFile file(path);
+    if (file.open(QFile::WriteOnly)) {
+        file.write(QJsonDocument(object).toJson(QJsonDocument::Compact));
+        file.commit();
+    }
+}
+
+void QOnlineTranslationJob::clearBingCredentials()
+{
+    QMutexLocker locker(&QOnlineTranslator::s_bingCredentialsMutex);
+    QOnlineTranslator::s_bingKey.clear();
+    QOnlineTranslator::s_bingToken.clear();
+    QOnlineTranslator::s_bingIg.clear();
+    QOnlineTranslator::s_bingIid.clear();
+    QOnlineTranslator::s_bingExpiration = {};
+    QFile::remove(bingCredentialsPath());
+}
+
+QString QOnlineTranslationJob::bingCredentialsPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QStringLiteral("/bing-credentials.json");
+}
+
+void QOnlineTranslationJob::resetData(QOnlineTranslator::TranslationError error, const QString &errorString)
+{
+    m_error = error;
+    m_errorString = errorString;
+    m_translation.clear();
+    m_translationTranslit.clear();
+    m_sourceTranslit.clear();
+    m_sourceTranscription.clear();
+    m_translationOptions.clear();
+    m_examples.clear();
+
+    abortChunks();
+    abortSegments();
+
+    // Let the engine rest before next requests
+    if (error == QOnlineTranslator::ServiceError && m_scheduler != nullptr)
+        m_scheduler->reportServiceError(m_engine);
+
+    // Stop the pipeline, the job will be finished like after the last step
+    if (!m_steps.isEmpty()) {
+        m_steps.clear();
+        m_finishTimer->start();
+    }
+}
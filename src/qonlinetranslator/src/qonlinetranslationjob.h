@@ -0,0 +1,516 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef QONLINETRANSLATIONJOB_H
+#define QONLINETRANSLATIONJOB_H
+
+#include "qonlinetranslator.h"
+#include "qtextsegmenter.h"
+
+#include <QElapsedTimer>
+#include <QHash>
+
+class QNetworkReply;
+class QTimer;
+
+/**
+ * @brief Provides translation data of a single request
+ *
+ * Created by QOnlineTranslator::startTranslation() or QOnlineTranslator::startLanguageDetection().
+ * Each job has its own results, so several jobs can run at the same time.
+ * All jobs of a translator share its network access manager.
+ * Settings of the translator are copied when the job is created.
+ * Identical translations that run at the same time share requests and results.
+ * If hedging is enabled in the translator, a slow translation is also requested from the hedging engine.
+ * If incremental translation is enabled in the translator, groups of sentences of an edited text are translated separately.
+ */
+class QOnlineTranslationJob : public QObject
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(QOnlineTranslationJob)
+
+    friend class QOnlineBatchTranslationJob;
+    friend class QOnlineTranslator;
+    friend class QOnlineDispatchBenchmark; // Compares the step pipeline with the state machine
+    friend class QOnlineGoogleBlocksBenchmark; // Feeds Google responses with different data blocks
+    friend class QOnlineTranslationJobBenchmark; // Feeds recorded responses to parsers
+    friend class QOnlineTranslatorTest; // Checks internal helpers
+
+public:
+    ~QOnlineTranslationJob() override;
+
+    /**
+     * @brief Cancel translation operation (if any).
+     */
+    void abort();
+
+    /**
+     * @brief Check translation progress
+     *
+     * @return `true` when the translation is still processing and has not finished or was aborted yet.
+     */
+    bool isRunning() const;
+
+    /**
+     * @brief Converts the object to JSON
+     *
+     * @return JSON representation
+     */
+    QJsonDocument toJson() const;
+
+    /**
+     * @brief Source text
+     *
+     * @return source text
+     */
+    const QString &source() const;
+
+    /**
+     * @brief Source transliteration
+     *
+     * @return transliteration of the source text
+     */
+    const QString &sourceTranslit() const;
+
+    /**
+     * @brief Source transcription
+     *
+     * @return transcription of the source text
+     */
+    const QString &sourceTranscription() const;
+
+    /**
+     * @brief Source language name
+     *
+     * @return language name of the source text
+     */
+    QString sourceLanguageName() const;
+
+    /**
+     * @brief Source language
+     *
+     * @return language of the source text
+     */
+    QOnlineTranslator::Language sourceLanguage() const;
+
+    /**
+     * @brief Engine
+     *
+     * @return engine that provided the results, may differ from the requested one if the hedging engine answered first
+     * @sa QOnlineTranslator::setHedgingEngine()
+     */
+    QOnlineTranslator::Engine engine() const;
+
+    /**
+     * @brief Translated text
+     *
+     * @return translated text.
+     */
+    const QString &translation() const;
+
+    /**
+     * @brief Translation transliteration
+     *
+     * @return transliteration of the translated text
+     */
+    const QString &translationTranslit() const;
+
+    /**
+     * @brief Translation language name
+     *
+     * @return language name of the translated text
+     */
+    QString translationLanguageName() const;
+
+    /**
+     * @brief Translation language
+     *
+     * @return language of the translated text
+     */
+    QOnlineTranslator::Language translationLanguage() const;
+
+    /**
+     * @brief Translation options
+     *
+     * @return QMap whose key represents the type of speech, and the value is a QVector of translation options
+     * @sa QOption
+     */
+    const QMap<QString, QVector<QOption>> &translationOptions() const;
+
+    /**
+     * @brief Translation examples
+     *
+     * @return QMap whose key represents the type of speech, and the value is a QVector of translation examples
+     * @sa QExample
+     */
+    const QMap<QString, QVector<QExample>> &examples() const;
+
+    /**
+     * @brief Timings of network requests
+     *
+     * @return timings of each request in the order of sending
+     * @sa QOnlineTranslator::setTimingsEnabled()
+     */
+    const QVector<QRequestTiming> &timings() const;
+
+    /**
+     * @brief Number of repeated requests
+     *
+     * @return number of requests that were sent again after a network failure or timeout
+     * @sa QOnlineTranslator::setMaxRetries()
+     */
+    int retryCount() const;
+
+    /**
+     * @brief Last error
+     *
+     * Error that was found during the processing of the translation.
+     * If no error was found, returns QOnlineTranslator::NoError.
+     * The text of the error can be obtained by errorString().
+     *
+     * @return last error
+     */
+    QOnlineTranslator::TranslationError error() const;
+
+    /**
+     * @brief Last error string
+     *
+     * A human-readable description of the translation error that occurred.
+     *
+     * @return last error string
+     */
+    const QString &errorString() const;
+
+signals:
+    /**
+     * @brief Translation finished
+     *
+     * This signal is called when the translation is complete.
+     */
+    void finished();
+
+    /**
+     * @brief Part of the translation is available
+     *
+     * Long texts are translated in several parts, this signal is called after each part is received.
+     * At this moment translation() returns all parts received so far.
+     * Unlike finished(), the job should not be deleted from the connected slot.
+     *
+     * @param offset position of the part in translation()
+     * @param text translation of the part
+     */
+    void partialTranslationAvailable(int offset, const QString &text);
+
+private slots:
+    // Google
+    QNetworkReply *requestGoogleTranslate(const QString &text);
+    void parseGoogleTranslate();
+
+    QNetworkReply *requestYandexTranslate(const QString &text);
+    void parseYandexTranslate();
+
+    QNetworkReply *requestYandexSourceTranslit(const QString &text);
+    void parseYandexSourceTranslit();
+
+    QNetworkReply *requestYandexTranslationTranslit(const QString &text);
+    void parseYandexTranslationTranslit();
+
+    QNetworkReply *requestYandexDictionary(const QString &text);
+    void parseYandexDictionary();
+
+    // Bing
+    QNetworkReply *requestBingCredentials(const QString &);
+    void parseBingCredentials();
+
+    QNetworkReply *requestBingTranslate(const QString &text);
+    void parseBingTranslate();
+
+    QNetworkReply *requestBingDictionary(const QString &text);
+    void parseBingDictionary();
+
+    // LibreTranslate
+    QNetworkReply *requestLibreLangDetection(const QString &text);
+    void parseLibreLangDetection();
+
+    QNetworkReply *requestLibreTranslate(const QString &text);
+    void parseLibreTranslate();
+
+    // Lingva
+    QNetworkReply *requestLingvaTranslate(const QString &text);
+    void parseLingvaTranslate();
+
+    // Hedging
+    void startHedging();
+    void finishHedging();
+
+    // Incremental translation
+    void finishSegment(int index);
+
+private:
+    // Request returns nullptr if there is nothing to request
+    using RequestMethod = QNetworkReply *(QOnlineTranslationJob::*)(const QString &text);
+    using ParseMethod = void (QOnlineTranslationJob::*)();
+
+    // Values to search in the Bing web version
+    enum BingMarker {
+        BingCredentialsMarker,
+        BingIgMarker,
+        BingIidMarker,
+        BingMarkersCount
+    };
+
+    struct BingMarkersAutomaton {
+        QVector<int> transitions; // 256 transitions for each state
+        QVector<int> matches; // Found marker for each state or -1
+    };
+
+    // Part of the text that fits into the engine limit
+    struct Chunk {
+        QTextSegmenter::Segment segment;
+        QPointer<QNetworkReply> reply;
+        bool scheduled = false; // Waits for the scheduler to send the request
+        qint64 queueTime = 0; // When the part was queued for sending
+        int timing = -1; // Index in timings if recorded
+        qint64 sendTime = 0;
+        int retries = 0;
+    };
+
+    // Request of the engine pipeline
+    struct Step {
+        RequestMethod requestMethod;
+        ParseMethod parseMethod;
+        const QString QOnlineTranslationJob::*text = nullptr; // Read when the step starts since it may depend on previous steps
+        int textLimit = 0; // Split the text into parts by this limit if specified, s_engineChunkSize to use the engine chunk size
+        bool firstPartOnly = false; // Send only the first part (for language detection)
+        int dependency = -1; // Index of the step whose results are needed, steps without dependency start immediately
+
+        // Progress
+        bool started = false;
+        bool finished = false;
+        QString chunksText;
+        QVector<Chunk> chunks;
+        int sentChunks = 0;
+        int parsedChunks = 0;
+        int generation = 0; // Changed when parts are split again to ignore outdated scheduled requests
+    };
+
+    // Copies settings from the translator
+    explicit QOnlineTranslationJob(QOnlineTranslator *translator);
+
+    void translate(const QString &text, QOnlineTranslator::Engine engine, QOnlineTranslator::Language translationLang, QOnlineTranslator::Language sourceLang, QOnlineTranslator::Language uiLang);
+    void detectLanguage(const QString &text, QOnlineTranslator::Engine engine);
+    void retranslate();
+    void abortRequests();
+
+    /*
+     * Engines have translation limit, so need to split all text into parts and make request sequentially.
+     * Also Yandex and Bing requires several requests to get dictionary, transliteration etc.
+     * We build a list of steps, each step starts from reply signals when the step it depends on is finished,
+     * so independent steps run at the same time.
+     */
+    void buildGooglePipeline();
+    void buildGoogleDetectPipeline();
+
+    void buildYandexPipeline();
+    void buildYandexDetectPipeline();
+
+    void buildBingPipeline();
+    void buildBingDetectPipeline();
+
+    void buildLibrePipeline();
+    void buildLibreDetectPipeline();
+
+    void buildLingvaPipeline();
+    void buildLingvaDetectPipeline();
+
+    void startSteps();
+    void startStep(int stepIndex);
+
+    // Helper functions for cache
+    QString cacheKey(const QString &source) const;
+    QString contextKey() const;
+    bool loadFromCache();
+    void storeToCache();
+
+    /*
+     * The first job of identical translations (with the same cache key) sends requests,
+     * other jobs wait for it and copy its results when it finishes.
+     * If the first job is aborted, waiting jobs translate by themselves.
+     */
+    bool joinRunningTranslation();
+    void leaveRunningTranslation();
+    void shareResults();
+    void copyResults(const QOnlineTranslationJob *job);
+
+    // Helper functions for hedging
+    void abortHedging();
+
+    // Helper functions for incremental translation
+    bool translateSegments();
+    void startSegments();
+    void showSegments();
+    void emitPartialTranslation();
+    void abortSegments();
+    static QVector<QTextSegmenter::Segment> sentenceGroups(const QString &text);
+
+    // Helper functions for concurrent requests
+    void sendChunks(int stepIndex);
+    QNetworkReply *sendChunk(int stepIndex, int index);
+    void scheduleChunk(int stepIndex, int index);
+    void parseChunks(int stepIndex);
+    bool retryChunk(int stepIndex, int index);
+    bool splitRejectedChunk(int stepIndex, int index);
+    void resendChunk(int stepIndex, int index);
+    void renewBingCredentials(int stepIndex, int index);
+    void abortChunks();
+    void startTiming(int stepIndex, int index);
+    void startDeadlines(QNetworkReply *reply, qint64 queued = 0) const;
+    static bool isTransientFailure(const QNetworkReply *reply);
+    static bool isOffline();
+    int chunkSize() const;
+    void tuneChunkSize(const Chunk &chunk);
+    static QString engineUrl(const QString &customUrl, const QString &defaultUrl);
+
+    // Helper functions for transliteration
+    QNetworkReply *requestYandexTranslit(QOnlineTranslator::Language language, const QString &text);
+    void parseYandexTranslit(QString &text);
+
+    // Helper functions for Bing credentials that are shared between processes
+    void scanBingCredentials(QNetworkReply *reply);
+    static bool loadBingCredentials();
+    static void saveBingCredentials();
+    static void clearBingCredentials();
+    static QString bingCredentialsPath();
+    static const BingMarkersAutomaton &bingMarkersAutomaton();
+
+    void resetData(QOnlineTranslator::TranslationError error = QOnlineTranslator::NoError, const QString &errorString = {});
+
+    // Used if Bing does not provide credentials lifetime
+    static constexpr qint64 s_bingDefaultLifetime = 3600000;
+
+    // Previously credentials variable name was "params_RichTranslateHelper", now it called
+    // "params_AbusePreventionHelper". OH, IRONY!
+    static constexpr const char *s_bingMarkers[BingMarkersCount] = {"var params_AbusePreventionHelper = [", "IG:\"", "data-iid=\""};
+    static constexpr char s_bingMarkerTerminators[BingMarkersCount] = {']', '"', '"'};
+    static constexpr int s_bingAllMarkers = (1 << BingMarkersCount) - 1;
+    static constexpr int s_bingMaxValueSize = 1024;
+
+    // A group of sentences ends after a sentence with hash divisible by this value, so groups have 4 sentences on average
+    static constexpr uint s_segmentSentences = 4;
+    static constexpr int s_maxSegmentLength = 1000;
+
+    // Text limit of steps that translate text, replaced by the configured or tuned chunk size of the engine
+    static constexpr int s_engineChunkSize = -1;
+
+    // Bounds of the tuned chunk size and allowed growth of the response time per character to keep growing
+    static constexpr int s_minChunkSize = 50;
+    static constexpr int s_maxChunkSize = 100000;
+    static constexpr int s_maxChunkSizeGrowth = 4; // Fixed round trip time makes larger parts always look faster per character
+    static constexpr double s_chunkLatencyTolerance = 1.2;
+
+    // Initial delay before the first retry, doubled for each next one
+    static constexpr int s_retryDelay = 500;
+
+    // Set on replies that were aborted by a deadline
+    static constexpr const char *s_timedOutProperty = "TimedOut";
+
+    // Jobs that send requests for translations, by cache key.
+    // Jobs can share results only within a thread, so each thread has its own jobs
+    static inline thread_local QHash<QString, QOnlineTranslationJob *> s_runningTranslations;
+
+    QPointer<QOnlineTranslator> m_translator;
+    QNetworkAccessManager *m_networkManager;
+    QPointer<QNetworkReply> m_currentReply;
+    QPointer<QOnlineTranslationCache> m_cache;
+    QPointer<QOnlineRequestScheduler> m_scheduler;
+    QTimer *m_finishTimer;
+    QString m_cacheKey;
+
+    // Pipeline state
+    QVector<Step> m_steps;
+    int m_chunksGeneration = 0; // Changed when parts are aborted to ignore outdated scheduled requests
+
+    // Hedging state
+    QTimer *m_hedgingTimer;
+    QPointer<QOnlineTranslationJob> m_hedgingJob;
+    QOnlineTranslator::Engine m_hedgingEngine;
+    int m_hedgingDelay;
+
+    // Incremental translation state
+    QVector<QTextSegmenter::Segment> m_segments; // Groups of sentences without surrounding spaces
+    QVector<QOnlineTranslationJob *> m_segmentJobs; // For each group, nullptr until started
+    int m_startedSegments = 0;
+    int m_runningSegments = 0;
+    int m_shownSegments = 0; // Groups appended to the translation
+    int m_shownSegmentSize = 0; // Size of the next group translation already appended from its parts
+    int m_shownTranslationSize = 0; // Size of the translation already reported by partialTranslationAvailable()
+
+    // Identical translations state
+    QOnlineTranslationJob *m_leader = nullptr;
+    QVector<QOnlineTranslationJob *> m_followers;
+
+    QOnlineTranslator::Engine m_engine = QOnlineTranslator::Google;
+    QOnlineTranslator::Language m_sourceLang = QOnlineTranslator::NoLanguage;
+    QOnlineTranslator::Language m_requestedSourceLang = QOnlineTranslator::NoLanguage;
+    QOnlineTranslator::Language m_translationLang = QOnlineTranslator::NoLanguage;
+    QOnlineTranslator::Language m_uiLang = QOnlineTranslator::NoLanguage;
+    QOnlineTranslator::TranslationError m_error = QOnlineTranslator::NoError;
+
+    QString m_source;
+    QString m_sourceTranslit;
+    QString m_sourceTranscription;
+    QString m_translation;
+    QString m_translationTranslit;
+    QString m_errorString;
+
+    // Self-hosted engines settings
+    QByteArray m_libreApiKey;
+    QString m_libreUrl;
+    QString m_lingvaUrl;
+
+    // Replace default hosts of other engines if not empty
+    QString m_googleUrl;
+    QString m_yandexUrl;
+    QString m_bingUrl;
+
+    QMap<QOnlineTranslator::Engine, int> m_engineConcurrency;
+    QMap<QOnlineTranslator::Engine, int> m_engineResponseTimeouts;
+    QMap<QOnlineTranslator::Engine, int> m_engineTimeouts;
+    int m_maxRetries;
+    QMap<QOnlineTranslator::Engine, int> m_engineChunkSizes;
+    int m_retryCount = 0;
+    double m_offlineDetectionThreshold;
+
+    QMap<QString, QVector<QOption>> m_translationOptions;
+    QMap<QString, QVector<QExample>> m_examples;
+    QVector<QRequestTiming> m_timings;
+    QElapsedTimer m_timingsClock;
+
+    bool m_sourceTranslitEnabled;
+    bool m_translationTranslitEnabled;
+    bool m_sourceTranscriptionEnabled;
+    bool m_translationOptionsEnabled;
+    bool m_examplesEnabled;
+    bool m_timingsEnabled;
+    bool m_incrementalTranslationEnabled;
+    bool m_chunkSizeTuningEnabled;
+
+    bool m_onlyDetectLanguage = false;
+
+    // Streaming search state of Bing credentials
+    QByteArray m_bingMarkerValues[BingMarkersCount];
+    int m_bingMarkersState = 0;
+    int m_bingCapturedMarker = -1;
+    int m_bingFoundMarkers = 0;
+
+    // Time of the last credentials renewal by this job, -1 if they were not renewed
+    qint64 m_bingCredentialsTime = -1;
+    QPointer<QNetworkReply> m_bingCredentialsReply;
+    bool m_bingRetryPending = false;
+};
+
+#endif // QONLINETRANSLATIONJOB_H
@@ -7,383 +7,593 @@
 
 #include "qonlinetranslator.h"
 
+#include "qonlinebatchtranslationjob.h"
+#include "qonlinetranslationcache.h"
+#include "qonlinetranslationjob.h"
 #include "qonlinetts.h"
 
-#include <QCoreApplication>
-#include <QFinalState>
-#include <QJsonArray>
 #include <QJsonDocument>
-#include <QJsonObject>
 #include <QMediaPlayer>
-#include <QNetworkReply>
-#include <QStateMachine>
-
-const QMap<QOnlineTranslator::Language, QString> QOnlineTranslator::s_genericLanguageCodes = {
-    {Auto, QStringLiteral("auto")},
-    {Afrikaans, QStringLiteral("af")},
-    {Albanian, QStringLiteral("sq")},
-    {Amharic, QStringLiteral("am")},
-    {Arabic, QStringLiteral("ar")},
-    {Armenian, QStringLiteral("hy")},
-    {Azerbaijani, QStringLiteral("az")},
-    {Bashkir, QStringLiteral("ba")},
-    {Basque, QStringLiteral("eu")},
-    {Belarusian, QStringLiteral("be")},
-    {Bengali, QStringLiteral("bn")},
-    {Bosnian, QStringLiteral("bs")},
-    {Bulgarian, QStringLiteral("bg")},
-    {Cantonese, QStringLiteral("yue")},
-    {Catalan, QStringLiteral("ca")},
-    {Cebuano, QStringLiteral("ceb")},
-    {Chichewa, QStringLiteral("ny")},
-    {Corsican, QStringLiteral("co")},
-    {Croatian, QStringLiteral("hr")},
-    {Czech, QStringLiteral("cs")},
-    {Danish, QStringLiteral("da")},
-    {Dutch, QStringLiteral("nl")},
-    {English, QStringLiteral("en")},
-    {Esperanto, QStringLiteral("eo")},
-    {Estonian, QStringLiteral("et")},
-    {Fijian, QStringLiteral("fj")},
-    {Filipino, QStringLiteral("fil")},
-    {Finnish, QStringLiteral("fi")},
-    {French, QStringLiteral("fr")},
-    {Frisian, QStringLiteral("fy")},
-    {Galician, QStringLiteral("gl")},
-    {Georgian, QStringLiteral("ka")},
-    {German, QStringLiteral("de")},
-    {Greek, QStringLiteral("el")},
-    {Gujarati, QStringLiteral("gu")},
-    {HaitianCreole, QStringLiteral("ht")},
-    {Hausa, QStringLiteral("ha")},
-    {Hawaiian, QStringLiteral("haw")},
-    {Hebrew, QStringLiteral("he")},
-    {HillMari, QStringLiteral("mrj")},
-    {Hindi, QStringLiteral("hi")},
-    {Hmong, QStringLiteral("hmn")},
-    {Hungarian, QStringLiteral("hu")},
-    {Icelandic, QStringLiteral("is")},
-    {Igbo, QStringLiteral("ig")},
-    {Indonesian, QStringLiteral("id")},
-    {Irish, QStringLiteral("ga")},
-    {Italian, QStringLiteral("it")},
-    {Japanese, QStringLiteral("ja")},
-    {Javanese, QStringLiteral("jw")},
-    {Kannada, QStringLiteral("kn")},
-    {Kazakh, QStringLiteral("kk")},
-    {Khmer, QStringLiteral("km")},
-    {Kinyarwanda, QStringLiteral("rw")},
-    {Klingon, QStringLiteral("tlh")},
-    {KlingonPlqaD, QStringLiteral("tlh-Qaak")},
-    {Korean, QStringLiteral("ko")},
-    {Kurdish, QStringLiteral("ku")},
-    {Kyrgyz, QStringLiteral("ky")},
-    {Lao, QStringLiteral("lo")},
-    {Latin, QStringLiteral("la")},
-    {Latvian, QStringLiteral("lv")},
-    {LevantineArabic, QStringLiteral("apc")},
-    {Lithuanian, QStringLiteral("lt")},
-    {Luxembourgish, QStringLiteral("lb")},
-    {Macedonian, QStringLiteral("mk")},
-    {Malagasy, QStringLiteral("mg")},
-    {Malay, QStringLiteral("ms")},
-    {Malayalam, QStringLiteral("ml")},
-    {Maltese, QStringLiteral("mt")},
-    {Maori, QStringLiteral("mi")},
-    {Marathi, QStringLiteral("mr")},
-    {Mari, QStringLiteral("mhr")},
-    {Mongolian, QStringLiteral("mn")},
-    {Myanmar, QStringLiteral("my")},
-    {Nepali, QStringLiteral("ne")},
-    {Norwegian, QStringLiteral("no")},
-    {Oriya, QStringLiteral("or")},
-    {Papiamento, QStringLiteral("pap")},
-    {Pashto, QStringLiteral("ps")},
-    {Persian, QStringLiteral("fa")},
-    {Polish, QStringLiteral("pl")},
-    {Portuguese, QStringLiteral("pt")},
-    {Punjabi, QStringLiteral("pa")},
-    {QueretaroOtomi, QStringLiteral("otq")},
-    {Romanian, QStringLiteral("ro")},
-    {Russian, QStringLiteral("ru")},
-    {Samoan, QStringLiteral("sm")},
-    {ScotsGaelic, QStringLiteral("gd")},
-    {SerbianCyrillic, QStringLiteral("sr")},
-    {SerbianLatin, QStringLiteral("sr-Latin")},
-    {Sesotho, QStringLiteral("st")},
-    {Shona, QStringLiteral("sn")},
-    {SimplifiedChinese, QStringLiteral("zh-CN")},
-    {Sindhi, QStringLiteral("sd")},
-    {Sinhala, QStringLiteral("si")},
-    {Slovak, QStringLiteral("sk")},
-    {Slovenian, QStringLiteral("sl")},
-    {Somali, QStringLiteral("so")},
-    {Spanish, QStringLiteral("es")},
-    {Sundanese, QStringLiteral("su")},
-    {Swahili, QStringLiteral("sw")},
-    {Swedish, QStringLiteral("sv")},
-    {Tagalog, QStringLiteral("tl")},
-    {Tahitian, QStringLiteral("ty")},
-    {Tajik, QStringLiteral("tg")},
-    {Tamil, QStringLiteral("ta")},
-    {Tatar, QStringLiteral("tt")},
-    {Telugu, QStringLiteral("te")},
-    {Thai, QStringLiteral("th")},
-    {Tongan, QStringLiteral("to")},
-    {TraditionalChinese, QStringLiteral("zh-TW")},
-    {Turkish, QStringLiteral("tr")},
-    {Turkmen, QStringLiteral("tk")},
-    {Udmurt, QStringLiteral("udm")},
-    {Uighur, QStringLiteral("ug")},
-    {Ukrainian, QStringLiteral("uk")},
-    {Urdu, QStringLiteral("ur")},
-    {Uzbek, QStringLiteral("uz")},
-    {Vietnamese, QStringLiteral("vi")},
-    {Welsh, QStringLiteral("cy")},
-    {Xhosa, QStringLiteral("xh")},
-    {Yiddish, QStringLiteral("yi")},
-    {Yoruba, QStringLiteral("yo")},
-    {YucatecMaya, QStringLiteral("yua")},
-    {Zulu, QStringLiteral("zu")}};
-
-const QMap<QOnlineTranslator::Language, QString> QOnlineTranslator::s_googleLanguageCodes = {
-    {Hebrew, QStringLiteral("iw")}};
-
-const QMap<QOnlineTranslator::Language, QString> QOnlineTranslator::s_yandexLanguageCodes = {
-    {SimplifiedChinese, QStringLiteral("zn")},
-    {Javanese, QStringLiteral("jv")}};
-
-const QMap<QOnlineTranslator::Language, QString> QOnlineTranslator::s_bingLanguageCodes = {
-    {Auto, QStringLiteral("auto-detect")},
-    {Bosnian, QStringLiteral("bs-Latn")},
-    {SerbianCyrillic, QStringLiteral("sr-Cyrl")},
-    {SimplifiedChinese, QStringLiteral("zh-Hans")},
-    {TraditionalChinese, QStringLiteral("zh-Hant")},
-    {Hmong, QStringLiteral("mww")}};
-
-const QMap<QOnlineTranslator::Language, QString> QOnlineTranslator::s_lingvaLanguageCodes = {
-    {SimplifiedChinese, QStringLiteral("zh")},
-    {TraditionalChinese, QStringLiteral("zh_HANT")}};
-
-QOnlineTranslator::QOnlineTranslator(QObject *parent)
-    : QObject(parent)
-    , m_stateMachine(new QStateMachine(this))
-    , m_networkManager(new QNetworkAccessManager(this))
-{
-    connect(m_stateMachine, &QStateMachine::finished, this, &QOnlineTranslator::finished);
-    connect(m_stateMachine, &QStateMachine::stopped, this, &QOnlineTranslator::finished);
-}
-
-void QOnlineTranslator::translate(const QString &text, Engine engine, Language translationLang, Language sourceLang, Language uiLang)
+#include <QNetworkAccessManager>
+#include <QTimer>
+#include <QUrl>
+
+constexpr QOnlineTranslator::LanguageCode QOnlineTranslator::s_genericLanguageCodes[] = {
+    {Auto, "auto"},
+    {Afrikaans, "af"},
+    {Albanian, "sq"},
+    {Amharic, "am"},
+    {Arabic, "ar"},
+    {Armenian, "hy"},
+    {Azerbaijani, "az"},
+    {Bashkir, "ba"},
+    {Basque, "eu"},
+    {Belarusian, "be"},
+    {Bengali, "bn"},
+    {Bosnian, "bs"},
+    {Bulgarian, "bg"},
+    {Cantonese, "yue"},
+    {Catalan, "ca"},
+    {Cebuano, "ceb"},
+    {Chichewa, "ny"},
+    {Corsican, "co"},
+    {Croatian, "hr"},
+    {Czech, "cs"},
+    {Danish, "da"},
+    {Dutch, "nl"},
+    {English, "en"},
+    {Esperanto, "eo"},
+    {Estonian, "et"},
+    {Fijian, "fj"},
+    {Filipino, "fil"},
+    {Finnish, "fi"},
+    {French, "fr"},
+    {Frisian, "fy"},
+    {Galician, "gl"},
+    {Georgian, "ka"},
+    {German, "de"},
+    {Greek, "el"},
+    {Gujarati, "gu"},
+    {HaitianCreole, "ht"},
+    {Hausa, "ha"},
+    {Hawaiian, "haw"},
+    {Hebrew, "he"},
+    {HillMari, "mrj"},
+    {Hindi, "hi"},
+    {Hmong, "hmn"},
+    {Hungarian, "hu"},
+    {Icelandic, "is"},
+    {Igbo, "ig"},
+    {Indonesian, "id"},
+    {Irish, "ga"},
+    {Italian, "it"},
+    {Japanese, "ja"},
+    {Javanese, "jw"},
+    {Kannada, "kn"},
+    {Kazakh, "kk"},
+    {Khmer, "km"},
+    {Kinyarwanda, "rw"},
+    {Klingon, "tlh"},
+    {KlingonPlqaD, "tlh-Qaak"},
+    {Korean, "ko"},
+    {Kurdish, "ku"},
+    {Kyrgyz, "ky"},
+    {Lao, "lo"},
+    {Latin, "la"},
+    {Latvian, "lv"},
+    {LevantineArabic, "apc"},
+    {Lithuanian, "lt"},
+    {Luxembourgish, "lb"},
+    {Macedonian, "mk"},
+    {Malagasy, "mg"},
+    {Malay, "ms"},
+    {Malayalam, "ml"},
+    {Maltese, "mt"},
+    {Maori, "mi"},
+    {Marathi, "mr"},
+    {Mari, "mhr"},
+    {Mongolian, "mn"},
+    {Myanmar, "my"},
+    {Nepali, "ne"},
+    {Norwegian, "no"},
+    {Oriya, "or"},
+    {Papiamento, "pap"},
+    {Pashto, "ps"},
+    {Persian, "fa"},
+    {Polish, "pl"},
+    {Portuguese, "pt"},
+    {Punjabi, "pa"},
+    {QueretaroOtomi, "otq"},
+    {Romanian, "ro"},
+    {Russian, "ru"},
+    {Samoan, "sm"},
+    {ScotsGaelic, "gd"},
+    {SerbianCyrillic, "sr"},
+    {SerbianLatin, "sr-Latin"},
+    {Sesotho, "st"},
+    {Shona, "sn"},
+    {SimplifiedChinese, "zh-CN"},
+    {Sindhi, "sd"},
+    {Sinhala, "si"},
+    {Slovak, "sk"},
+    {Slovenian, "sl"},
+    {Somali, "so"},
+    {Spanish, "es"},
+    {Sundanese, "su"},
+    {Swahili, "sw"},
+    {Swedish, "sv"},
+    {Tagalog, "tl"},
+    {Tahitian, "ty"},
+    {Tajik, "tg"},
+    {Tamil, "ta"},
+    {Tatar, "tt"},
+    {Telugu, "te"},
+    {Thai, "th"},
+    {Tongan, "to"},
+    {TraditionalChinese, "zh-TW"},
+    {Turkish, "tr"},
+    {Turkmen, "tk"},
+    {Udmurt, "udm"},
+    {Uighur, "ug"},
+    {Ukrainian, "uk"},
+    {Urdu, "ur"},
+    {Uzbek, "uz"},
+    {Vietnamese, "vi"},
+    {Welsh, "cy"},
+    {Xhosa, "xh"},
+    {Yiddish, "yi"},
+    {Yoruba, "yo"},
+    {YucatecMaya, "yua"},
+    {Zulu, "zu"}};
+
+constexpr QOnlineTranslator::LanguageCode QOnlineTranslator::s_googleLanguageCodes[] = {
+    {Hebrew, "iw"}};
+
+constexpr QOnlineTranslator::LanguageCode QOnlineTranslator::s_yandexLanguageCodes[] = {
+    {SimplifiedChinese, "zn"},
+    {Javanese, "jv"}};
+
+constexpr QOnlineTranslator::LanguageCode QOnlineTranslator::s_bingLanguageCodes[] = {
+    {Auto, "auto-detect"},
+    {Bosnian, "bs-Latn"},
+    {SerbianCyrillic, "sr-Cyrl"},
+    {SimplifiedChinese, "zh-Hans"},
+    {TraditionalChinese, "zh-Hant"},
+    {Hmong, "mww"}};
+
+constexpr QOnlineTranslator::LanguageCode QOnlineTranslator::s_lingvaLanguageCodes[] = {
+    {SimplifiedChinese, "zh"},
+    {TraditionalChinese, "zh_HANT"}};
+
+// Used to generate language tables at compile time
+constexpr bool QOnlineTranslator::isSupportTranslationByEngine(Engine engine, Language lang)
 {
-    abort();
-    resetData();
-
-    m_onlyDetectLanguage = false;
-    m_source = text;
-    m_sourceLang = sourceLang;
-    m_translationLang = translationLang == Auto ? language(QLocale()) : translationLang;
-    m_uiLang = uiLang == Auto ? language(QLocale()) : uiLang;
-
-    // Check if the selected languages are supported by the engine
-    if (!isSupportTranslation(engine, m_sourceLang)) {
-        resetData(ParametersError, tr("Selected source language %1 is not supported for %2").arg(languageName(m_sourceLang), QMetaEnum::fromType<Engine>().valueToKey(engine)));
-        emit finished();
-        return;
-    }
-    if (!isSupportTranslation(engine, m_translationLang)) {
-        resetData(ParametersError, tr("Selected translation language %1 is not supported for %2").arg(languageName(m_translationLang), QMetaEnum::fromType<Engine>().valueToKey(engine)));
-        emit finished();
-        return;
-    }
-    if (!isSupportTranslation(engine, m_uiLang)) {
-        resetData(ParametersError, tr("Selected ui language %1 is not supported for %2").arg(languageName(m_uiLang), QMetaEnum::fromType<Engine>().valueToKey(engine)));
-        emit finished();
-        return;
-    }
-
     switch (engine) {
     case Google:
-        buildGoogleStateMachine();
-        break;
+    case Lingva: // Lingva is a frontend to Google Translate
+        switch (lang) {
+        case NoLanguage:
+        case Bashkir:
+        case Cantonese:
+        case Fijian:
+        case Filipino:
+        case Georgian:
+        case HillMari:
+        case Klingon:
+        case KlingonPlqaD:
+        case LevantineArabic:
+        case Mari:
+        case Papiamento:
+        case QueretaroOtomi:
+        case SerbianLatin:
+        case Tahitian:
+        case Tongan:
+        case Udmurt:
+        case YucatecMaya:
+            return false;
+        default:
+            return true;
+        }
     case Yandex:
-        buildYandexStateMachine();
-        break;
+        switch (lang) {
+        case NoLanguage:
+        case Cantonese:
+        case Chichewa:
+        case Corsican:
+        case Fijian:
+        case Filipino:
+        case Frisian:
+        case Hausa:
+        case Hawaiian:
+        case Igbo:
+        case Kinyarwanda:
+        case Klingon:
+        case KlingonPlqaD:
+        case Kurdish:
+        case LevantineArabic:
+        case Oriya:
+        case Pashto:
+        case QueretaroOtomi:
+        case Samoan:
+        case SerbianLatin:
+        case Sesotho:
+        case Shona:
+        case Sindhi:
+        case Somali:
+        case Tahitian:
+        case Tongan:
+        case Turkmen:
+        case Uighur:
+        case Yoruba:
+        case YucatecMaya:
+        case Zulu:
+            return false;
+        default:
+            return true;
+        }
     case Bing:
-        buildBingStateMachine();
-        break;
+        switch (lang) {
+        case NoLanguage:
+        case Albanian:
+        case Amharic:
+        case Armenian:
+        case Azerbaijani:
+        case Basque:
+        case Bashkir:
+        case Belarusian:
+        case Cebuano:
+        case Corsican:
+        case Esperanto:
+        case Frisian:
+        case Galician:
+        case Georgian:
+        case Gujarati:
+        case Hausa:
+        case Hawaiian:
+        case HillMari:
+        case Igbo:
+        case Irish:
+        case Javanese:
+        case Kannada:
+        case Kazakh:
+        case Khmer:
+        case Kinyarwanda:
+        case Kurdish:
+        case Kyrgyz:
+        case Lao:
+        case Latin:
+        case Luxembourgish:
+        case Macedonian:
+        case Malayalam:
+        case Maori:
+        case Marathi:
+        case Mari:
+        case Mongolian:
+        case Myanmar:
+        case Nepali:
+        case Oriya:
+        case Chichewa:
+        case Papiamento:
+        case Pashto:
+        case Punjabi:
+        case ScotsGaelic:
+        case Sesotho:
+        case Shona:
+        case Sindhi:
+        case Sinhala:
+        case Somali:
+        case Sundanese:
+        case Tagalog:
+        case Tajik:
+        case Tatar:
+        case Turkmen:
+        case Uighur:
+        case Udmurt:
+        case Uzbek:
+        case Xhosa:
+        case Yiddish:
+        case Yoruba:
+        case Zulu:
+            return false;
+        default:
+            return true;
+        }
     case LibreTranslate:
-        if (m_libreUrl.isEmpty()) {
-            resetData(ParametersError, tr("%1 URL can't be empty.").arg(QMetaEnum::fromType<Engine>().valueToKey(engine)));
-            emit finished();
-            return;
+        switch (lang) {
+        case NoLanguage:
+        case Afrikaans:
+        case Amharic:
+        case Armenian:
+        case Bashkir:
+        case Basque:
+        case Belarusian:
+        case Bosnian:
+        case Cantonese:
+        case Cebuano:
+        case Chichewa:
+        case Corsican:
+        case Croatian:
+        case Fijian:
+        case Filipino:
+        case Frisian:
+        case Galician:
+        case Georgian:
+        case Gujarati:
+        case HaitianCreole:
+        case Hausa:
+        case Hawaiian:
+        case HillMari:
+        case Hmong:
+        case Icelandic:
+        case Igbo:
+        case Javanese:
+        case Kannada:
+        case Kazakh:
+        case Khmer:
+        case Kinyarwanda:
+        case Klingon:
+        case KlingonPlqaD:
+        case Kurdish:
+        case Kyrgyz:
+        case Lao:
+        case Latin:
+        case LevantineArabic:
+        case Luxembourgish:
+        case Macedonian:
+        case Malagasy:
+        case Malayalam:
+        case Maltese:
+        case Maori:
+        case Marathi:
+        case Mari:
+        case Mongolian:
+        case Myanmar:
+        case Nepali:
+        case Oriya:
+        case Papiamento:
+        case Pashto:
+        case Punjabi:
+        case QueretaroOtomi:
+        case Samoan:
+        case ScotsGaelic:
+        case SerbianCyrillic:
+        case SerbianLatin:
+        case Sesotho:
+        case Shona:
+        case SimplifiedChinese:
+        case Sindhi:
+        case Sinhala:
+        case Somali:
+        case Sundanese:
+        case Swahili:
+        case Tahitian:
+        case Tajik:
+        case Tamil:
+        case Tatar:
+        case Telugu:
+        case Tongan:
+        case Turkmen:
+        case Udmurt:
+        case Uighur:
+        case Urdu:
+        case Uzbek:
+        case Welsh:
+        case Xhosa:
+        case Yiddish:
+        case Yoruba:
+        case YucatecMaya:
+        case Zulu:
+            return false;
+        default:
+            return true;
         }
+    }
 
-        buildLibreStateMachine();
-        break;
-    case Lingva:
-        if (m_lingvaUrl.isEmpty()) {
-            resetData(ParametersError, tr("%1 URL can't be empty.").arg(QMetaEnum::fromType<Engine>().valueToKey(engine)));
-            emit finished();
-            return;
-        }
+    return false;
+}
 
-        buildLingvaStateMachine();
-        break;
+// Engine-specific codes override generic codes in both directions
+constexpr QOnlineTranslator::LanguageTable QOnlineTranslator::languageTable(const LanguageCode *engineCodes, int engineCodesCount)
+{
+    LanguageTable table;
+    for (int i = 0; i < engineCodesCount; ++i)
+        addLanguageCode(table, engineCodes[i]);
+    for (const LanguageCode &languageCode : s_genericLanguageCodes)
+        addLanguageCode(table, languageCode);
+
+    // Insertion sort since std::sort is not constexpr in C++17
+    for (int i = 1; i < table.sortedCodesCount; ++i) {
+        const LanguageCode languageCode = table.sortedCodes[i];
+        int j = i;
+        for (; j > 0 && compareCodes(table.sortedCodes[j - 1].code, languageCode.code) > 0; --j)
+            table.sortedCodes[j] = table.sortedCodes[j - 1];
+        table.sortedCodes[j] = languageCode;
     }
 
-    m_stateMachine->start();
+    for (int lang = Auto; lang < s_languagesCount; ++lang)
+        table.supportedLanguages[lang / 64] |= quint64(1) << (lang % 64);
+
+    return table;
 }
 
-void QOnlineTranslator::detectLanguage(const QString &text, Engine engine)
+constexpr QOnlineTranslator::LanguageTable QOnlineTranslator::languageTable(Engine engine, const LanguageCode *engineCodes, int engineCodesCount)
 {
-    abort();
-    resetData();
+    LanguageTable table = languageTable(engineCodes, engineCodesCount);
+    for (int lang = Auto; lang < s_languagesCount; ++lang) {
+        if (!isSupportTranslationByEngine(engine, static_cast<Language>(lang))) {
+            table.codes[lang] = nullptr;
+            table.supportedLanguages[lang / 64] &= ~(quint64(1) << (lang % 64));
+        }
+    }
 
-    m_onlyDetectLanguage = true;
-    m_source = text;
-    m_sourceLang = Auto;
-    m_translationLang = English;
-    m_uiLang = language(QLocale());
+    return table;
+}
 
-    switch (engine) {
-    case Google:
-        buildGoogleDetectStateMachine();
-        break;
-    case Yandex:
-        buildYandexDetectStateMachine();
-        break;
-    case Bing:
-        buildBingDetectStateMachine();
-        break;
-    case LibreTranslate:
-        if (m_libreUrl.isEmpty()) {
-            resetData(ParametersError, tr("%1 URL can't be empty.").arg(QMetaEnum::fromType<Engine>().valueToKey(engine)));
-            emit finished();
-            return;
-        }
+constexpr void QOnlineTranslator::addLanguageCode(LanguageTable &table, LanguageCode languageCode)
+{
+    if (table.codes[languageCode.lang] == nullptr)
+        table.codes[languageCode.lang] = languageCode.code;
 
-        buildLibreDetectStateMachine();
-        break;
-    case Lingva:
-        if (m_lingvaUrl.isEmpty()) {
-            resetData(ParametersError, tr("%1 URL can't be empty.").arg(QMetaEnum::fromType<Engine>().valueToKey(engine)));
-            emit finished();
+    for (int i = 0; i < table.sortedCodesCount; ++i) {
+        if (compareCodes(table.sortedCodes[i].code, languageCode.code) == 0)
             return;
-        }
+    }
+    table.sortedCodes[table.sortedCodesCount++] = languageCode;
+}
 
-        buildLingvaDetectStateMachine();
-        break;
+constexpr int QOnlineTranslator::compareCodes(const char *first, const char *second)
+{
+    while (*first != '\0' && *first == *second) {
+        ++first;
+        ++second;
     }
+    return static_cast<unsigned char>(*first) - static_cast<unsigned char>(*second);
+}
+
+constexpr QOnlineTranslator::LanguageTable QOnlineTranslator::s_genericLanguageTable = languageTable(nullptr, 0);
+
+// Indexed by engine
+constexpr QOnlineTranslator::LanguageTable QOnlineTranslator::s_languageTables[s_enginesCount] = {
+    languageTable(Google, s_googleLanguageCodes, std::size(s_googleLanguageCodes)),
+    languageTable(Yandex, s_yandexLanguageCodes, std::size(s_yandexLanguageCodes)),
+    languageTable(Bing, s_bingLanguageCodes, std::size(s_bingLanguageCodes)),
+    languageTable(LibreTranslate, nullptr, 0),
+    languageTable(Lingva, s_lingvaLanguageCodes, std::size(s_lingvaLanguageCodes))};
+
+QOnlineTranslator::QOnlineTranslator(QObject *parent)
+    : QObject(parent)
+    , m_networkManager(new QNetworkAccessManager(this))
+    , m_keepAliveTimer(new QTimer(this))
+{
+    // Empty job to provide initial data
+    m_job = new QOnlineTranslationJob(this);
 
-    m_stateMachine->start();
+    connect(m_keepAliveTimer, &QTimer::timeout, this, [this] {
+        openConnections(m_warmUpEngine);
+    });
 }
 
-void QOnlineTranslator::abort()
+void QOnlineTranslator::translate(const QString &text, Engine engine, Language translationLang, Language sourceLang, Language uiLang)
 {
-    if (m_currentReply != nullptr)
-        m_currentReply->abort();
+    resetJob();
+    m_job->translate(text, engine, translationLang, sourceLang, uiLang);
 }
 
-bool QOnlineTranslator::isRunning() const
+void QOnlineTranslator::detectLanguage(const QString &text, Engine engine)
 {
-    return m_stateMachine->isRunning();
+    resetJob();
+    m_job->detectLanguage(text, engine);
 }
 
-QJsonDocument QOnlineTranslator::toJson() const
+QOnlineTranslationJob *QOnlineTranslator::startTranslation(const QString &text, Engine engine, Language translationLang, Language sourceLang, Language uiLang)
 {
-    QJsonObject translationOptions;
-    for (auto it = m_translationOptions.cbegin(); it != m_translationOptions.cend(); ++it) {
-        QJsonArray arr;
-        for (const QOption &option : it.value())
-            arr.append(option.toJson());
-        translationOptions.insert(it.key(), arr);
-    }
+    auto *job = new QOnlineTranslationJob(this);
+    job->translate(text, engine, translationLang, sourceLang, uiLang);
+    return job;
+}
 
-    QJsonObject examples;
-    for (auto it = m_examples.cbegin(); it != m_examples.cend(); ++it) {
-        QJsonArray arr;
-        for (const QExample &example : it.value())
-            arr.append(example.toJson());
-        examples.insert(it.key(), arr);
-    }
+QOnlineBatchTranslationJob *QOnlineTranslator::translateBatch(const QStringList &texts, Engine engine, Language translationLang, Language sourceLang)
+{
+    auto *job = new QOnlineBatchTranslationJob(this);
+    job->translate(texts, engine, translationLang, sourceLang);
+    return job;
+}
+
+QOnlineTranslationJob *QOnlineTranslator::startLanguageDetection(const QString &text, Engine engine)
+{
+    auto *job = new QOnlineTranslationJob(this);
+    job->detectLanguage(text, engine);
+    return job;
+}
+
+void QOnlineTranslator::abort()
+{
+    m_job->abort();
+}
 
-    QJsonObject object{
-        {"examples", qMove(examples)},
-        {"source", m_source},
-        {"sourceTranscription", m_sourceTranscription},
-        {"sourceTranslit", m_sourceTranslit},
-        {"translation", m_translation},
-        {"translationOptions", qMove(translationOptions)},
-        {"translationTranslit", m_translationTranslit},
-    };
+bool QOnlineTranslator::isRunning() const
+{
+    return m_job->isRunning();
+}
 
-    return QJsonDocument(object);
+QJsonDocument QOnlineTranslator::toJson() const
+{
+    return m_job->toJson();
 }
 
 const QString &QOnlineTranslator::source() const
 {
-    return m_source;
+    return m_job->source();
 }
 
 const QString &QOnlineTranslator::sourceTranslit() const
 {
-    return m_sourceTranslit;
+    return m_job->sourceTranslit();
 }
 
 const QString &QOnlineTranslator::sourceTranscription() const
 {
-    return m_sourceTranscription;
+    return m_job->sourceTranscription();
 }
 
 QString QOnlineTranslator::sourceLanguageName() const
 {
-    return languageName(m_sourceLang);
+    return m_job->sourceLanguageName();
 }
 
 QOnlineTranslator::Language QOnlineTranslator::sourceLanguage() const
 {
-    return m_sourceLang;
+    return m_job->sourceLanguage();
 }
 
 const QString &QOnlineTranslator::translation() const
 {
-    return m_translation;
+    return m_job->translation();
 }
 
 const QString &QOnlineTranslator::translationTranslit() const
 {
-    return m_translationTranslit;
+    return m_job->translationTranslit();
 }
 
 QString QOnlineTranslator::translationLanguageName() const
 {
-    return languageName(m_translationLang);
+    return m_job->translationLanguageName();
 }
 
 QOnlineTranslator::Language QOnlineTranslator::translationLanguage() const
 {
-    return m_translationLang;
+    return m_job->translationLanguage();
 }
 
 const QMap<QString, QVector<QOption>> &QOnlineTranslator::translationOptions() const
 {
-    return m_translationOptions;
+    return m_job->translationOptions();
 }
 
 const QMap<QString, QVector<QExample>> &QOnlineTranslator::examples() const
 {
-    return m_examples;
+    return m_job->examples();
+}
+
+const QVector<QRequestTiming> &QOnlineTranslator::timings() const
+{
+    return m_job->timings();
+}
+
+int QOnlineTranslator::retryCount() const
+{
+    return m_job->retryCount();
 }
 
 QOnlineTranslator::TranslationError QOnlineTranslator::error() const
 {
-    return m_error;
+    return m_job->error();
 }
 
 const QString &QOnlineTranslator::errorString() const
 {
-    return m_errorString;
+    return m_job->errorString();
 }
 
 bool QOnlineTranslator::isSourceTranslitEnabled() const
@@ -436,17 +646,44 @@ void QOnlineTranslator::setExamplesEnabled(bool enable)
     m_examplesEnabled = enable;
 }
 
+bool QOnlineTranslator::isTimingsEnabled() const
+{
+    return m_timingsEnabled;
+}
+
+void QOnlineTranslator::setTimingsEnabled(bool enable)
+{
+    m_timingsEnabled = enable;
+}
+
+bool QOnlineTranslator::isIncrementalTranslationEnabled() const
+{
+    return m_incrementalTranslationEnabled;
+}
+
+void QOnlineTranslator::setIncrementalTranslationEnabled(bool enable)
+{
+    m_incrementalTranslationEnabled = enable;
+}
+
 void QOnlineTranslator::setEngineUrl(Engine engine, QString url)
 {
     switch (engine) {
+    case Google:
+        m_googleUrl = qMove(url);
+        break;
+    case Yandex:
+        m_yandexUrl = qMove(url);
+        break;
+    case Bing:
+        m_bingUrl = qMove(url);
+        break;
     case LibreTranslate:
         m_libreUrl = qMove(url);
         break;
     case Lingva:
         m_lingvaUrl = qMove(url);
         break;
-    default:
-        break;
     }
 }
 
@@ -461,6 +698,197 @@ void QOnlineTranslator::setEngineApiKey(Engine engine, QByteArray apiKey)
     }
 }
 
+int QOnlineTranslator::engineConcurrency(Engine engine) const
+{
+    return m_engineConcurrency.value(engine, 1);
+}
+
+void QOnlineTranslator::setEngineConcurrency(Engine engine, int concurrency)
+{
+    m_engineConcurrency[engine] = qMax(1, concurrency);
+}
+
+int QOnlineTranslator::engineResponseTimeout(Engine engine) const
+{
+    return m_engineResponseTimeouts.value(engine, s_defaultResponseTimeout);
+}
+
+void QOnlineTranslator::setEngineResponseTimeout(Engine engine, int msec)
+{
+    m_engineResponseTimeouts[engine] = qMax(0, msec);
+}
+
+int QOnlineTranslator::engineTimeout(Engine engine) const
+{
+    return m_engineTimeouts.value(engine, s_defaultTimeout);
+}
+
+void QOnlineTranslator::setEngineTimeout(Engine engine, int msec)
+{
+    m_engineTimeouts[engine] = qMax(0, msec);
+}
+
+int QOnlineTranslator::maxRetries() const
+{
+    return m_maxRetries;
+}
+
+void QOnlineTranslator::setMaxRetries(int retries)
+{
+    m_maxRetries = qMax(0, retries);
+}
+
+int QOnlineTranslator::engineChunkSize(Engine engine) const
+{
+    return m_engineChunkSizes.value(engine, defaultChunkSize(engine));
+}
+
+void QOnlineTranslator::setEngineChunkSize(Engine engine, int size)
+{
+    if (size > 0)
+        m_engineChunkSizes[engine] = size;
+    else
+        m_engineChunkSizes.remove(engine);
+
+    // Start tuning from the new size
+    m_chunkSizeTuning.remove(engine);
+}
+
+bool QOnlineTranslator::isChunkSizeTuningEnabled() const
+{
+    return m_chunkSizeTuningEnabled;
+}
+
+void QOnlineTranslator::setChunkSizeTuningEnabled(bool enable)
+{
+    m_chunkSizeTuningEnabled = enable;
+}
+
+QOnlineTranslator::Engine QOnlineTranslator::hedgingEngine() const
+{
+    return m_hedgingEngine;
+}
+
+void QOnlineTranslator::setHedgingEngine(Engine engine)
+{
+    m_hedgingEngine = engine;
+}
+
+int QOnlineTranslator::hedgingDelay() const
+{
+    return m_hedgingDelay;
+}
+
+void QOnlineTranslator::setHedgingDelay(int msec)
+{
+    m_hedgingDelay = qMax(0, msec);
+}
+
+double QOnlineTranslator::offlineDetectionThreshold() const
+{
+    return m_offlineDetectionThreshold;
+}
+
+void QOnlineTranslator::setOfflineDetectionThreshold(double threshold)
+{
+    m_offlineDetectionThreshold = threshold;
+}
+
+QOnlineTranslationCache *QOnlineTranslator::cache() const
+{
+    return m_cache;
+}
+
+void QOnlineTranslator::setCache(QOnlineTranslationCache *cache)
+{
+    m_cache = cache;
+}
+
+QOnlineRequestScheduler *QOnlineTranslator::scheduler() const
+{
+    return m_scheduler;
+}
+
+void QOnlineTranslator::setScheduler(QOnlineRequestScheduler *scheduler)
+{
+    m_scheduler = scheduler;
+}
+
+void QOnlineTranslator::warmUp(Engine engine)
+{
+    m_warmUpEngine = engine;
+    m_warmedUp = true;
+    openConnections(engine);
+
+    // Postpone the next keep-alive since connections were just opened
+    if (m_keepAliveInterval > 0)
+        m_keepAliveTimer->start(m_keepAliveInterval);
+}
+
+int QOnlineTranslator::keepAliveInterval() const
+{
+    return m_keepAliveInterval;
+}
+
+void QOnlineTranslator::setKeepAliveInterval(int msec)
+{
+    m_keepAliveInterval = qMax(0, msec);
+
+    // Keep only connections that were explicitly requested
+    if (m_keepAliveInterval > 0 && m_warmedUp)
+        m_keepAliveTimer->start(m_keepAliveInterval);
+    else
+        m_keepAliveTimer->stop();
+}
+
+// Hosts should match URLs used in requests to reuse the connections
+void QOnlineTranslator::openConnections(Engine engine)
+{
+    QList<QUrl> urls;
+    switch (engine) {
+    case Google:
+        urls = {QUrl(m_googleUrl.isEmpty() ? QStringLiteral("https://translate.googleapis.com") : m_googleUrl)};
+        break;
+    case Yandex:
+        if (m_yandexUrl.isEmpty())
+            urls = {QUrl(QStringLiteral("https://translate.yandex.net")), QUrl(QStringLiteral("https://dictionary.yandex.net"))};
+        else
+            urls = {QUrl(m_yandexUrl)};
+        break;
+    case Bing:
+        urls = {QUrl(m_bingUrl.isEmpty() ? QStringLiteral("https://www.bing.com") : m_bingUrl)};
+        break;
+    case LibreTranslate:
+        urls = {QUrl(m_libreUrl)};
+        break;
+    case Lingva:
+        urls = {QUrl(m_lingvaUrl)};
+        break;
+    }
+
+    for (const QUrl &url : qAsConst(urls)) {
+        if (url.host().isEmpty())
+            continue;
+
+        if (url.scheme() == QLatin1String("https"))
+            m_networkManager->connectToHostEncrypted(url.host(), static_cast<quint16>(url.port(443)));
+        else
+            m_networkManager->connectToHost(url.host(), static_cast<quint16>(url.port(80)));
+    }
+}
+
+// Replace the job of single-shot API, results of the previous job are discarded
+void QOnlineTranslator::resetJob()
+{
+    m_job->disconnect(this);
+    m_job->abort();
+    m_job->deleteLater();
+
+    m_job = new QOnlineTranslationJob(this);
+    connect(m_job, &QOnlineTranslationJob::finished, this, &QOnlineTranslator::finished);
+    connect(m_job, &QOnlineTranslationJob::partialTranslationAvailable, this, &QOnlineTranslator::partialTranslationAvailable);
+}
+
 QString QOnlineTranslator::languageName(Language lang)
 {
     switch (lang) {
@@ -723,7 +1151,10 @@ QString QOnlineTranslator::languageName(Language lang)
 
 QString QOnlineTranslator::languageCode(Language lang)
 {
-    return s_genericLanguageCodes.value(lang);
+    if (lang == NoLanguage)
+        return {};
+
+    return QString::fromLatin1(s_genericLanguageTable.codes[lang]);
 }
 
 QOnlineTranslator::Language QOnlineTranslator::language(const QLocale &locale)
@@ -804,1250 +1235,165 @@ QOnlineTranslator::Language QOnlineTranslator::language(const QLocale &locale)
     case QLocale::Igbo:
         return Igbo;
     case QLocale::Indonesian:
-        return Indonesian;
-    case QLocale::Irish:
-        return Irish;
-    case QLocale::Italian:
-        return Italian;
-    case QLocale::Japanese:
-        return Japanese;
-    case QLocale::Javanese:
-        return Javanese;
-    case QLocale::Kannada:
-        return Kannada;
-    case QLocale::Kazakh:
-        return Kazakh;
-    case QLocale::Khmer:
-        return Khmer;
-    case QLocale::Kinyarwanda:
-        return Kinyarwanda;
-    case QLocale::Korean:
-        return Korean;
-    case QLocale::Kurdish:
-        return Kurdish;
-    case QLocale::Lao:
-        return Lao;
-    case QLocale::Latin:
-        return Latin;
-    case QLocale::Latvian:
-        return Latvian;
-    case QLocale::Lithuanian:
-        return Lithuanian;
-    case QLocale::Luxembourgish:
-        return Luxembourgish;
-    case QLocale::Macedonian:
-        return Macedonian;
-    case QLocale::Malagasy:
-        return Malagasy;
-    case QLocale::Malay:
-        return Malay;
-    case QLocale::Malayalam:
-        return Malayalam;
-    case QLocale::Maltese:
-        return Maltese;
-    case QLocale::Maori:
-        return Maori;
-    case QLocale::Marathi:
-        return Marathi;
-    case QLocale::Mongolian:
-        return Mongolian;
-    case QLocale::Nepali:
-        return Nepali;
-    case QLocale::NorwegianBokmal:
-        return Norwegian;
-    case QLocale::Oriya:
-        return Oriya;
-    case QLocale::Pashto:
-        return Pashto;
-    case QLocale::Persian:
-        return Persian;
-    case QLocale::Polish:
-        return Polish;
-    case QLocale::Portuguese:
-        return Portuguese;
-    case QLocale::Punjabi:
-        return Punjabi;
-    case QLocale::Romanian:
-        return Romanian;
-    case QLocale::Russian:
-        return Russian;
-    case QLocale::Samoan:
-        return Samoan;
-    case QLocale::Gaelic:
-        return ScotsGaelic;
-    case QLocale::Serbian:
-        return SerbianCyrillic;
-    case QLocale::Shona:
-        return Shona;
-    case QLocale::Sindhi:
-        return Sindhi;
-    case QLocale::Sinhala:
-        return Sinhala;
-    case QLocale::Slovak:
-        return Slovak;
-    case QLocale::Slovenian:
-        return Slovenian;
-    case QLocale::Somali:
-        return Somali;
-    case QLocale::Spanish:
-        return Spanish;
-    case QLocale::Sundanese:
-        return Sundanese;
-    case QLocale::Swahili:
-        return Swahili;
-    case QLocale::Swedish:
-        return Swedish;
-    case QLocale::Filipino:
-        return Filipino;
-    case QLocale::Tajik:
-        return Tajik;
-    case QLocale::Tamil:
-        return Tamil;
-    case QLocale::Tatar:
-        return Tatar;
-    case QLocale::Telugu:
-        return Telugu;
-    case QLocale::Thai:
-        return Thai;
-    case QLocale::Turkish:
-        return Turkish;
-    case QLocale::Turkmen:
-        return Turkmen;
-    case QLocale::Uighur:
-        return Uighur;
-    case QLocale::Ukrainian:
-        return Ukrainian;
-    case QLocale::Urdu:
-        return Urdu;
-    case QLocale::Uzbek:
-        return Uzbek;
-    case QLocale::Vietnamese:
-        return Vietnamese;
-    case QLocale::Welsh:
-        return Welsh;
-    case QLocale::Xhosa:
-        return Xhosa;
-    case QLocale::Yiddish:
-        return Yiddish;
-    case QLocale::Yoruba:
-        return Yoruba;
-    case QLocale::Zulu:
-        return Zulu;
-    default:
-        return English;
-    }
-}
-
-// Returns general language code
-QOnlineTranslator::Language QOnlineTranslator::language(const QString &langCode)
-{
-    return s_genericLanguageCodes.key(langCode, NoLanguage);
-}
-
-bool QOnlineTranslator::isSupportTranslation(Engine engine, Language lang)
-{
-    bool isSupported = false;
-
-    switch (engine) {
-    case Google:
-    case Lingva: // Lingva is a frontend to Google Translate
-        switch (lang) {
-        case NoLanguage:
-        case Bashkir:
-        case Cantonese:
-        case Fijian:
-        case Filipino:
-        case Georgian:
-        case HillMari:
-        case Klingon:
-        case KlingonPlqaD:
-        case LevantineArabic:
-        case Mari:
-        case Papiamento:
-        case QueretaroOtomi:
-        case SerbianLatin:
-        case Tahitian:
-        case Tongan:
-        case Udmurt:
-        case YucatecMaya:
-            isSupported = false;
-            break;
-        default:
-            isSupported = true;
-            break;
-        }
-        break;
-    case Yandex:
-        switch (lang) {
-        case NoLanguage:
-        case Cantonese:
-        case Chichewa:
-        case Corsican:
-        case Fijian:
-        case Filipino:
-        case Frisian:
-        case Hausa:
-        case Hawaiian:
-        case Igbo:
-        case Kinyarwanda:
-        case Klingon:
-        case KlingonPlqaD:
-        case Kurdish:
-        case LevantineArabic:
-        case Oriya:
-        case Pashto:
-        case QueretaroOtomi:
-        case Samoan:
-        case SerbianLatin:
-        case Sesotho:
-        case Shona:
-        case Sindhi:
-        case Somali:
-        case Tahitian:
-        case Tongan:
-        case Turkmen:
-        case Uighur:
-        case Yoruba:
-        case YucatecMaya:
-        case Zulu:
-            isSupported = false;
-            break;
-        default:
-            isSupported = true;
-            break;
-        }
-        break;
-    case Bing:
-        switch (lang) {
-        case NoLanguage:
-        case Albanian:
-        case Amharic:
-        case Armenian:
-        case Azerbaijani:
-        case Basque:
-        case Bashkir:
-        case Belarusian:
-        case Cebuano:
-        case Corsican:
-        case Esperanto:
-        case Frisian:
-        case Galician:
-        case Georgian:
-        case Gujarati:
-        case Hausa:
-        case Hawaiian:
-        case HillMari:
-        case Igbo:
-        case Irish:
-        case Javanese:
-        case Kannada:
-        case Kazakh:
-        case Khmer:
-        case Kinyarwanda:
-        case Kurdish:
-        case Kyrgyz:
-        case Lao:
-        case Latin:
-        case Luxembourgish:
-        case Macedonian:
-        case Malayalam:
-        case Maori:
-        case Marathi:
-        case Mari:
-        case Mongolian:
-        case Myanmar:
-        case Nepali:
-        case Oriya:
-        case Chichewa:
-        case Papiamento:
-        case Pashto:
-        case Punjabi:
-        case ScotsGaelic:
-        case Sesotho:
-        case Shona:
-        case Sindhi:
-        case Sinhala:
-        case Somali:
-        case Sundanese:
-        case Tagalog:
-        case Tajik:
-        case Tatar:
-        case Turkmen:
-        case Uighur:
-        case Udmurt:
-        case Uzbek:
-        case Xhosa:
-        case Yiddish:
-        case Yoruba:
-        case Zulu:
-            isSupported = false;
-            break;
-        default:
-            isSupported = true;
-            break;
-        }
-        break;
-    case LibreTranslate:
-        switch (lang) {
-        case NoLanguage:
-        case Afrikaans:
-        case Amharic:
-        case Armenian:
-        case Bashkir:
-        case Basque:
-        case Belarusian:
-        case Bosnian:
-        case Cantonese:
-        case Cebuano:
-        case Chichewa:
-        case Corsican:
-        case Croatian:
-        case Fijian:
-        case Filipino:
-        case Frisian:
-        case Galician:
-        case Georgian:
-        case Gujarati:
-        case HaitianCreole:
-        case Hausa:
-        case Hawaiian:
-        case HillMari:
-        case Hmong:
-        case Icelandic:
-        case Igbo:
-        case Javanese:
-        case Kannada:
-        case Kazakh:
-        case Khmer:
-        case Kinyarwanda:
-        case Klingon:
-        case KlingonPlqaD:
-        case Kurdish:
-        case Kyrgyz:
-        case Lao:
-        case Latin:
-        case LevantineArabic:
-        case Luxembourgish:
-        case Macedonian:
-        case Malagasy:
-        case Malayalam:
-        case Maltese:
-        case Maori:
-        case Marathi:
-        case Mari:
-        case Mongolian:
-        case Myanmar:
-        case Nepali:
-        case Oriya:
-        case Papiamento:
-        case Pashto:
-        case Punjabi:
-        case QueretaroOtomi:
-        case Samoan:
-        case ScotsGaelic:
-        case SerbianCyrillic:
-        case SerbianLatin:
-        case Sesotho:
-        case Shona:
-        case SimplifiedChinese:
-        case Sindhi:
-        case Sinhala:
-        case Somali:
-        case Sundanese:
-        case Swahili:
-        case Tahitian:
-        case Tajik:
-        case Tamil:
-        case Tatar:
-        case Telugu:
-        case Tongan:
-        case Turkmen:
-        case Udmurt:
-        case Uighur:
-        case Urdu:
-        case Uzbek:
-        case Welsh:
-        case Xhosa:
-        case Yiddish:
-        case Yoruba:
-        case YucatecMaya:
-        case Zulu:
-            isSupported = false;
-            break;
-        default:
-            isSupported = true;
-            break;
-        }
-        break;
-    }
-
-    return isSupported;
-}
-
-void QOnlineTranslator::skipGarbageText()
-{
-    m_translation.append(sender()->property(s_textProperty).toString());
-}
-
-void QOnlineTranslator::requestGoogleTranslate()
-{
-    const QString sourceText = sender()->property(s_textProperty).toString();
-
-    // Generate API url
-    QUrl url(QStringLiteral("https://translate.googleapis.com/translate_a/single"));
-    url.setQuery(QStringLiteral("client=gtx&ie=UTF-8&oe=UTF-8&dt=bd&dt=ex&dt=ld&dt=md&dt=rw&dt=rm&dt=ss&dt=t&dt=at&dt=qc&sl=%1&tl=%2&hl=%3&q=%4")
-                     .arg(languageApiCode(Google, m_sourceLang), languageApiCode(Google, m_translationLang), languageApiCode(Google, m_uiLang), QUrl::toPercentEncoding(sourceText)));
-
-    m_currentReply = m_networkManager->get(QNetworkRequest(url));
-}
-
-void QOnlineTranslator::parseGoogleTranslate()
-{
-    m_currentReply->deleteLater();
-
-    // Check for error
-    if (m_currentReply->error() != QNetworkReply::NoError) {
-        if (m_currentReply->error() == QNetworkReply::ServiceUnavailableError)
-            resetData(ServiceError, tr("Error: Engine systems have detected suspicious traffic from your computer network. Please try your request again later."));
-        else
-            resetData(NetworkError, m_currentReply->errorString());
-        return;
-    }
-
-    // Check availability of service
-    const QByteArray data = m_currentReply->readAll();
-    if (data.startsWith('<')) {
-        resetData(ServiceError, tr("Error: Engine systems have detected suspicious traffic from your computer network. Please try your request again later."));
-        return;
-    }
-
-    // Read Json
-    const QJsonDocument jsonResponse = QJsonDocument::fromJson(data);
-    const QJsonArray jsonData = jsonResponse.array();
-
-    if (m_sourceLang == Auto) {
-        // Parse language
-        m_sourceLang = language(Google, jsonData.at(2).toString());
-        if (m_sourceLang == NoLanguage) {
-            resetData(ParsingError, tr("Error: Unable to parse autodetected language"));
-            return;
-        }
-        if (m_onlyDetectLanguage)
-            return;
-    }
-
-    addSpaceBetweenParts(m_translation);
-    addSpaceBetweenParts(m_translationTranslit);
-    addSpaceBetweenParts(m_sourceTranslit);
-    for (const QJsonValueRef translationData : jsonData.at(0).toArray()) {
-        const QJsonArray translationArray = translationData.toArray();
-        m_translation.append(translationArray.at(0).toString());
-        if (m_translationTranslitEnabled)
-            m_translationTranslit.append(translationArray.at(2).toString());
-        if (m_sourceTranslitEnabled)
-            m_sourceTranslit.append(translationArray.at(3).toString());
-    }
-
-    if (m_source.size() >= s_googleTranslateLimit)
-        return;
-
-    // Translation options
-    if (m_translationOptionsEnabled) {
-        for (const QJsonValueRef typeOfSpeechData : jsonData.at(1).toArray()) {
-            const QJsonArray typeOfSpeechDataArray = typeOfSpeechData.toArray();
-            const QString typeOfSpeech = typeOfSpeechDataArray.at(0).toString();
-            for (const QJsonValueRef wordData : typeOfSpeechDataArray.at(2).toArray()) {
-                const QJsonArray wordDataArray = wordData.toArray();
-                const QString word = wordDataArray.at(0).toString();
-                const QString gender = wordDataArray.at(4).toString();
-                const QJsonArray translationsArray = wordDataArray.at(1).toArray();
-                QStringList translations;
-                translations.reserve(translationsArray.size());
-                for (const QJsonValue &wordTranslation : translationsArray)
-                    translations.append(wordTranslation.toString());
-                m_translationOptions[typeOfSpeech].append({word, gender, translations});
-            }
-        }
-    }
-
-    // Examples
-    if (m_examplesEnabled) {
-        for (const QJsonValueRef examplesData : jsonData.at(12).toArray()) {
-            const QJsonArray examplesDataArray = examplesData.toArray();
-            const QString typeOfSpeech = examplesDataArray.at(0).toString();
-
-            for (const QJsonValueRef exampleData : examplesDataArray.at(1).toArray()) {
-                const QJsonArray exampleArray = exampleData.toArray();
-                const QString example = exampleArray.at(2).toString();
-                const QString definition = exampleArray.at(0).toString();
-
-                m_examples[typeOfSpeech].append({example, definition});
-            }
-        }
-    }
-}
-
-void QOnlineTranslator::requestYandexTranslate()
-{
-    const QString sourceText = sender()->property(s_textProperty).toString();
-
-    QString lang;
-    if (m_sourceLang == Auto)
-        lang = languageApiCode(Yandex, m_translationLang);
-    else
-        lang = languageApiCode(Yandex, m_sourceLang) + '-' + languageApiCode(Yandex, m_translationLang);
-
-    // Generate API url
-    QUrl url(QStringLiteral("https://translate.yandex.net/api/v1/tr.json/translate"));
-    url.setQuery(QStringLiteral("ucid=%1&srv=android&text=%2&lang=%3")
-                     .arg(s_yandexUcid, QUrl::toPercentEncoding(sourceText), lang));
-
-    // Setup request
-    QNetworkRequest request;
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
-    request.setUrl(url);
-
-    // Make reply
-    m_currentReply = m_networkManager->post(request, QByteArray());
-}
-
-void QOnlineTranslator::parseYandexTranslate()
-{
-    m_currentReply->deleteLater();
-
-    // Check for errors
-    if (m_currentReply->error() != QNetworkReply::NoError) {
-        // Network errors
-        if (m_currentReply->error() < QNetworkReply::ContentAccessDenied) {
-            resetData(NetworkError, m_currentReply->errorString());
-            return;
-        }
-
-        // Parse data to get request error type
-        s_yandexUcid.clear();
-        const QJsonDocument jsonResponse = QJsonDocument::fromJson(m_currentReply->readAll());
-        resetData(ServiceError, jsonResponse.object().value(QStringLiteral("message")).toString());
-        return;
-    }
-
-    // Read Json
-    const QJsonDocument jsonResponse = QJsonDocument::fromJson(m_currentReply->readAll());
-    const QJsonObject jsonData = jsonResponse.object();
-
-    // Parse language
-    if (m_sourceLang == Auto) {
-        QString sourceCode = jsonData.value(QStringLiteral("lang")).toString();
-        sourceCode = sourceCode.left(sourceCode.indexOf('-'));
-        m_sourceLang = language(Yandex, sourceCode);
-        if (m_sourceLang == NoLanguage) {
-            resetData(ParsingError, tr("Error: Unable to parse autodetected language"));
-            return;
-        }
-        if (m_onlyDetectLanguage)
-            return;
-    }
-
-    // Parse translation data
-    m_translation += jsonData.value(QStringLiteral("text")).toArray().at(0).toString();
-}
-
-void QOnlineTranslator::requestYandexSourceTranslit()
-{
-    requestYandexTranslit(m_sourceLang);
-}
-
-void QOnlineTranslator::parseYandexSourceTranslit()
-{
-    parseYandexTranslit(m_sourceTranslit);
-}
-
-void QOnlineTranslator::requestYandexTranslationTranslit()
-{
-    requestYandexTranslit(m_translationLang);
-}
-
-void QOnlineTranslator::parseYandexTranslationTranslit()
-{
-    parseYandexTranslit(m_translationTranslit);
-}
-
-void QOnlineTranslator::requestYandexDictionary()
-{
-    // Check if language is supported (need to check here because language may be autodetected)
-    if (!isSupportDictionary(Yandex, m_sourceLang, m_translationLang) && !m_source.contains(' ')) {
-        auto *state = qobject_cast<QState *>(sender());
-        state->addTransition(new QFinalState(state->parentState()));
-        return;
-    }
-
-    // Generate API url
-    const QString text = sender()->property(s_textProperty).toString();
-    QUrl url(QStringLiteral("https://dictionary.yandex.net/dicservice.json/lookupMultiple"));
-    url.setQuery(QStringLiteral("text=%1&ui=%2&dict=%3-%4")
-                     .arg(QUrl::toPercentEncoding(text), languageApiCode(Yandex, m_uiLang), languageApiCode(Yandex, m_sourceLang), languageApiCode(Yandex, m_translationLang)));
-
-    m_currentReply = m_networkManager->get(QNetworkRequest(url));
-}
-
-void QOnlineTranslator::parseYandexDictionary()
-{
-    m_currentReply->deleteLater();
-
-    if (m_currentReply->error() != QNetworkReply::NoError) {
-        resetData(NetworkError, m_currentReply->errorString());
-        return;
-    }
-
-    // Parse reply
-    const QJsonDocument jsonResponse = QJsonDocument::fromJson(m_currentReply->readAll());
-    const QJsonValue jsonData = jsonResponse.object().value(languageApiCode(Yandex, m_sourceLang) + '-' + languageApiCode(Yandex, m_translationLang)).toObject().value(QStringLiteral("regular"));
-
-    if (m_sourceTranscriptionEnabled)
-        m_sourceTranscription = jsonData.toArray().at(0).toObject().value(QStringLiteral("ts")).toString();
-
-    for (const QJsonValueRef typeOfSpeechData : jsonData.toArray()) {
-        QJsonObject typeOfSpeechObject = typeOfSpeechData.toObject();
-        const QString typeOfSpeech = typeOfSpeechObject.value(QStringLiteral("pos")).toObject().value(QStringLiteral("text")).toString();
-        for (const QJsonValueRef wordData : typeOfSpeechObject.value(QStringLiteral("tr")).toArray()) {
-            // Parse translation options
-            const QJsonObject wordObject = wordData.toObject();
-            const QString word = wordObject.value(QStringLiteral("text")).toString();
-            const QString gender = wordObject.value(QStringLiteral("gen")).toObject().value(QStringLiteral("text")).toString();
-            const QJsonArray translationsArray = wordObject.value(QStringLiteral("mean")).toArray();
-            QStringList translations;
-            translations.reserve(translationsArray.size());
-            for (const QJsonValue &wordTranslation : translationsArray)
-                translations.append(wordTranslation.toObject().value(QStringLiteral("text")).toString());
-
-            m_translationOptions[typeOfSpeech].append({word, gender, translations});
-
-            // Parse examples
-            if (m_examplesEnabled && wordObject.contains(QLatin1String("ex"))) {
-                for (const QJsonValueRef exampleData : wordObject.value(QStringLiteral("ex")).toArray()) {
-                    const QJsonObject exampleObject = exampleData.toObject();
-                    const QString example = exampleObject.value(QStringLiteral("text")).toString();
-                    const QString description = exampleObject.value(QStringLiteral("tr")).toArray().first().toObject().value(QStringLiteral("text")).toString();
-
-                    m_examples[typeOfSpeech].append({example, description});
-                }
-            }
-        }
-    }
-}
-
-void QOnlineTranslator::requestBingCredentials()
-{
-    const QUrl url(QStringLiteral("https://www.bing.com/translator"));
-    m_currentReply = m_networkManager->get(QNetworkRequest(url));
-}
-
-void QOnlineTranslator::parseBingCredentials()
-{
-    m_currentReply->deleteLater();
-
-    if (m_currentReply->error() != QNetworkReply::NoError) {
-        resetData(NetworkError, m_currentReply->errorString());
-        return;
-    }
-
-    const QByteArray webSiteData = m_currentReply->readAll();
-    // Previously credentials variable name was "params_RichTranslateHelper", now it called
-    // "params_AbusePreventionHelper". OH, IRONY!
-    const QByteArray abuseBeginString = "var params_AbusePreventionHelper = [";
-    const int credentialsBeginPos = webSiteData.indexOf(abuseBeginString);
-    if (credentialsBeginPos == -1) {
-        resetData(ParsingError, tr("Error: Unable to find Bing credentials in web version."));
-        return;
-    }
-
-    const int keyBeginPos = credentialsBeginPos + abuseBeginString.size();
-    const int keyEndPos = webSiteData.indexOf(',', keyBeginPos);
-    if (keyEndPos == -1) {
-        resetData(ParsingError, tr("Error: Unable to extract Bing key from web version."));
-        return;
-    }
-    s_bingKey = webSiteData.mid(keyBeginPos, keyEndPos - keyBeginPos);
-
-    const int tokenBeginPos = keyEndPos + 2; // Skip two symbols instead of one because the value is enclosed in quotes
-    const int tokenEndPos = webSiteData.indexOf('"', tokenBeginPos);
-    if (tokenEndPos == -1) {
-        resetData(ParsingError, tr("Error: Unable to extract Bing token from web version."));
-        return;
-    }
-    s_bingToken = webSiteData.mid(tokenBeginPos, tokenEndPos - tokenBeginPos);
-
-    // This is offset for IG key, so if M$ change something on page again
-    // Crow will use constant string size as offset, istead of adjust
-    // offset mannually
-    const QByteArray igString = "IG:\"";
-    const int igBeginPos = webSiteData.indexOf(igString);
-    const int igEndPos = webSiteData.indexOf('"', igBeginPos + igString.size());
-    if (igEndPos == -1) {
-        resetData(ParsingError, tr("Error: Unable to extract additional Bing information from web version."));
-        return;
-    }
-    s_bingIg = webSiteData.mid(igBeginPos + igString.size(), igEndPos - (igBeginPos + igString.size()));
-
-    const QByteArray iidString = "data-iid=\"";
-    const int iidBeginPos = webSiteData.indexOf(iidString);
-    const int iidEndPos = webSiteData.indexOf('"', iidBeginPos + iidString.size());
-    if (iidEndPos == -1) {
-        resetData(ParsingError, tr("Error: Unable to extract additional Bing information from web version."));
-        return;
-    }
-    s_bingIid = webSiteData.mid(iidBeginPos + iidString.size(), iidEndPos - (iidBeginPos + iidString.size()));
-}
-
-void QOnlineTranslator::requestBingTranslate()
-{
-    const QString sourceText = sender()->property(s_textProperty).toString();
-
-    // Generate POST data
-    const QByteArray postData = "&text=" + QUrl::toPercentEncoding(sourceText)
-        + "&fromLang=" + languageApiCode(Bing, m_sourceLang).toUtf8()
-        + "&to=" + languageApiCode(Bing, m_translationLang).toUtf8()
-        + "&token=" + s_bingToken
-        + "&key=" + s_bingKey;
-
-    QUrl url(QStringLiteral("https://www.bing.com/ttranslatev3"));
-    url.setQuery(QStringLiteral("IG=%1&IID=%2").arg(s_bingIg, s_bingIid));
-
-    // Setup request
-    QNetworkRequest request;
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
-    request.setHeader(QNetworkRequest::UserAgentHeader, QCoreApplication::applicationName() + '/' + QCoreApplication::applicationVersion());
-    request.setUrl(url);
-
-    // Make reply
-    m_currentReply = m_networkManager->post(request, postData);
-}
-
-void QOnlineTranslator::parseBingTranslate()
-{
-    m_currentReply->deleteLater();
-
-    // Check for errors
-    if (m_currentReply->error() != QNetworkReply::NoError) {
-        resetData(NetworkError, m_currentReply->errorString());
-        return;
-    }
-
-    // Parse translation data
-    const QJsonDocument jsonResponse = QJsonDocument::fromJson(m_currentReply->readAll());
-    const QJsonObject responseObject = jsonResponse.array().first().toObject();
-
-    if (!jsonResponse.object().value(QStringLiteral("statusCode")).isNull()) {
-        const QString errorMessage = jsonResponse.object().value(QStringLiteral("errorMessage")).toString();
-
-        if (!errorMessage.isEmpty())
-            resetData(ServiceError, errorMessage);
-        else
-            resetData(ServiceError, tr("Error: Bing return unhandled network error"));
-        return;
-    }
-
-    if (m_sourceLang == Auto) {
-        const QString langCode = responseObject.value(QStringLiteral("detectedLanguage")).toObject().value(QStringLiteral("language")).toString();
-        m_sourceLang = language(Bing, langCode);
-        if (m_sourceLang == NoLanguage) {
-            resetData(ParsingError, tr("Error: Unable to parse autodetected language"));
-            return;
-        }
-        if (m_onlyDetectLanguage)
-            return;
-    }
-
-    const QJsonObject translationsObject = responseObject.value(QStringLiteral("translations")).toArray().first().toObject();
-    m_translation += translationsObject.value(QStringLiteral("text")).toString();
-    m_translationTranslit += translationsObject.value(QStringLiteral("transliteration")).toObject().value(QStringLiteral("text")).toString();
-}
-
-void QOnlineTranslator::requestBingDictionary()
-{
-    // Check if language is supported (need to check here because language may be autodetected)
-    if (!isSupportDictionary(Bing, m_sourceLang, m_translationLang) && !m_source.contains(' ')) {
-        auto *state = qobject_cast<QState *>(sender());
-        state->addTransition(new QFinalState(state->parentState()));
-        return;
-    }
-
-    // Generate POST data
-    const QByteArray postData = "&text=" + QUrl::toPercentEncoding(sender()->property(s_textProperty).toString())
-        + "&from=" + languageApiCode(Bing, m_sourceLang).toUtf8()
-        + "&to=" + languageApiCode(Bing, m_translationLang).toUtf8();
-
-    QNetworkRequest request;
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
-    request.setUrl(QStringLiteral("https://www.bing.com/tlookupv3"));
-
-    m_currentReply = m_networkManager->post(request, postData);
-}
-
-void QOnlineTranslator::parseBingDictionary()
-{
-    m_currentReply->deleteLater();
-
-    // Check for errors
-    if (m_currentReply->error() != QNetworkReply::NoError) {
-        resetData(NetworkError, m_currentReply->errorString());
-        return;
-    }
-
-    const QJsonDocument jsonResponse = QJsonDocument::fromJson(m_currentReply->readAll());
-    const QJsonObject responseObject = jsonResponse.array().first().toObject();
-
-    for (const QJsonValueRef dictionaryData : responseObject.value(QStringLiteral("translations")).toArray()) {
-        const QJsonObject dictionaryObject = dictionaryData.toObject();
-        const QString typeOfSpeech = dictionaryObject.value(QStringLiteral("posTag")).toString().toLower();
-        const QString word = dictionaryObject.value(QStringLiteral("displayTarget")).toString().toLower();
-        const QJsonArray translationsArray = dictionaryObject.value(QStringLiteral("backTranslations")).toArray();
-        QStringList translations;
-        translations.reserve(translationsArray.size());
-        for (const QJsonValue &wordTranslation : translationsArray)
-            translations.append(wordTranslation.toObject().value(QStringLiteral("displayText")).toString());
-
-        m_translationOptions[typeOfSpeech].append({word, {}, translations});
-    }
-}
-
-void QOnlineTranslator::requestLibreLangDetection()
-{
-    const QString sourceText = sender()->property(s_textProperty).toString();
-
-    // Generate POST data
-    const QByteArray postData = "&q=" + QUrl::toPercentEncoding(sourceText)
-        + "&api_key=" + m_libreApiKey;
-
-    // Setup request
-    QNetworkRequest request;
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
-    request.setUrl(m_libreUrl + "/detect");
-
-    // Make reply
-    m_currentReply = m_networkManager->post(request, postData);
-}
-
-void QOnlineTranslator::parseLibreLangDetection()
-{
-    m_currentReply->deleteLater();
-
-    // Check for errors
-    if (m_currentReply->error() != QNetworkReply::NoError) {
-        resetData(NetworkError, m_currentReply->errorString());
-        return;
-    }
-
-    const QJsonDocument jsonResponse = QJsonDocument::fromJson(m_currentReply->readAll());
-    const QJsonObject responseObject = jsonResponse.array().first().toObject();
-
-    if (m_sourceLang == Auto) {
-        const QString langCode = responseObject.value(QStringLiteral("language")).toString();
-        m_sourceLang = language(LibreTranslate, langCode);
-        if (m_sourceLang == NoLanguage) {
-            resetData(ParsingError, tr("Error: Unable to parse autodetected language"));
-        }
-    }
-}
-
-void QOnlineTranslator::requestLibreTranslate()
-{
-    const QString sourceText = sender()->property(s_textProperty).toString();
-
-    // Generate POST data
-    const QByteArray postData = "&q=" + QUrl::toPercentEncoding(sourceText)
-        + "&source=" + languageApiCode(LibreTranslate, m_sourceLang).toUtf8()
-        + "&target=" + languageApiCode(LibreTranslate, m_translationLang).toUtf8()
-        + "&api_key=" + m_libreApiKey;
-
-    // Setup request
-    QNetworkRequest request;
-    request.setHeader(QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
-    request.setUrl(m_libreUrl + "/translate");
-
-    // Make reply
-    m_currentReply = m_networkManager->post(request, postData);
-}
-
-void QOnlineTranslator::parseLibreTranslate()
-{
-    m_currentReply->deleteLater();
-
-    // Check for errors
-    if (m_currentReply->error() != QNetworkReply::NoError) {
-        resetData(NetworkError, m_currentReply->errorString());
-        return;
-    }
-
-    const QJsonDocument jsonResponse = QJsonDocument::fromJson(m_currentReply->readAll());
-    const QJsonObject responseObject = jsonResponse.object();
-
-    m_translation += responseObject.value(QStringLiteral("translatedText")).toString();
-}
-
-void QOnlineTranslator::requestLingvaTranslate()
-{
-    const QString sourceText = sender()->property(s_textProperty).toString();
-
-    // Generate API url
-    QUrl url(m_lingvaUrl + "/api/v1/"
-             + languageApiCode(Lingva, m_sourceLang) + "/"
-             + languageApiCode(Lingva, m_translationLang) + "/"
-             + QUrl::toPercentEncoding(sourceText));
-
-    m_currentReply = m_networkManager->get(QNetworkRequest(url));
-}
-
-void QOnlineTranslator::parseLingvaTranslate()
-{
-    m_currentReply->deleteLater();
-
-    // Check for errors
-    if (m_currentReply->error() != QNetworkReply::NoError) {
-        resetData(NetworkError, m_currentReply->errorString());
-        return;
-    }
-
-    // Parse translation data
-    const QJsonDocument jsonResponse = QJsonDocument::fromJson(m_currentReply->readAll());
-    const QJsonObject responseObject = jsonResponse.object();
-    const QJsonObject jsonData = responseObject.value(QStringLiteral("info")).toObject();
-
-    // Parse translation itself
-    m_translation = responseObject.value(QStringLiteral("translation")).toString();
-
-    // Parse transliteration, if enabled
-    if (m_translationTranslitEnabled)
-        m_translationTranslit = jsonData.value(QStringLiteral("pronunciation"))
-                                    .toObject()
-                                    .value(QStringLiteral("translation"))
-                                    .toString();
-
-    // Translation options
-    if (m_translationOptionsEnabled) {
-        for (const QJsonValueRef typeOfSpeechData : jsonData.value(QStringLiteral("extraTranslations")).toArray()) {
-            const QJsonObject speechDataObject = typeOfSpeechData.toObject();
-            const QJsonArray typeOfSpeechDataArray = speechDataObject.value(QStringLiteral("list")).toArray();
-            const QString typeOfSpeech = speechDataObject.value(QStringLiteral("type")).toString();
-            for (const QJsonValue &wordData : typeOfSpeechDataArray) {
-                const QJsonObject wordDataObject = wordData.toObject();
-                const QString word = wordDataObject.value(QStringLiteral("word")).toString();
-                const QJsonArray translationsArray = wordDataObject.value(QStringLiteral("meanings")).toArray();
-                QStringList translations;
-                translations.reserve(translationsArray.size());
-                for (const QJsonValue &wordTranslation : translationsArray)
-                    translations.append(wordTranslation.toString());
-                m_translationOptions[typeOfSpeech].append({word, QString(), translations});
-            }
-        }
-    }
-
-    // Examples
-    if (m_examplesEnabled) {
-        for (const QJsonValueRef examplesData : jsonData.value(QStringLiteral("definitions")).toArray()) {
-            const QJsonObject examplesObject = examplesData.toObject();
-            const QString typeOfSpeech = examplesObject.value(QStringLiteral("type")).toString();
-
-            for (const QJsonValueRef exampleData : examplesObject.value("list").toArray()) {
-                const QJsonObject exampleObject = exampleData.toObject();
-                const QString example = exampleObject.value(QStringLiteral("example")).toString();
-                const QString definition = exampleObject.value(QStringLiteral("definition")).toString();
-
-                m_examples[typeOfSpeech].append({example, definition});
-            }
-        }
+        return Indonesian;
+    case QLocale::Irish:
+        return Irish;
+    case QLocale::Italian:
+        return Italian;
+    case QLocale::Japanese:
+        return Japanese;
+    case QLocale::Javanese:
+        return Javanese;
+    case QLocale::Kannada:
+        return Kannada;
+    case QLocale::Kazakh:
+        return Kazakh;
+    case QLocale::Khmer:
+        return Khmer;
+    case QLocale::Kinyarwanda:
+        return Kinyarwanda;
+    case QLocale::Korean:
+        return Korean;
+    case QLocale::Kurdish:
+        return Kurdish;
+    case QLocale::Lao:
+        return Lao;
+    case QLocale::Latin:
+        return Latin;
+    case QLocale::Latvian:
+        return Latvian;
+    case QLocale::Lithuanian:
+        return Lithuanian;
+    case QLocale::Luxembourgish:
+        return Luxembourgish;
+    case QLocale::Macedonian:
+        return Macedonian;
+    case QLocale::Malagasy:
+        return Malagasy;
+    case QLocale::Malay:
+        return Malay;
+    case QLocale::Malayalam:
+        return Malayalam;
+    case QLocale::Maltese:
+        return Maltese;
+    case QLocale::Maori:
+        return Maori;
+    case QLocale::Marathi:
+        return Marathi;
+    case QLocale::Mongolian:
+        return Mongolian;
+    case QLocale::Nepali:
+        return Nepali;
+    case QLocale::NorwegianBokmal:
+        return Norwegian;
+    case QLocale::Oriya:
+        return Oriya;
+    case QLocale::Pashto:
+        return Pashto;
+    case QLocale::Persian:
+        return Persian;
+    case QLocale::Polish:
+        return Polish;
+    case QLocale::Portuguese:
+        return Portuguese;
+    case QLocale::Punjabi:
+        return Punjabi;
+    case QLocale::Romanian:
+        return Romanian;
+    case QLocale::Russian:
+        return Russian;
+    case QLocale::Samoan:
+        return Samoan;
+    case QLocale::Gaelic:
+        return ScotsGaelic;
+    case QLocale::Serbian:
+        return SerbianCyrillic;
+    case QLocale::Shona:
+        return Shona;
+    case QLocale::Sindhi:
+        return Sindhi;
+    case QLocale::Sinhala:
+        return Sinhala;
+    case QLocale::Slovak:
+        return Slovak;
+    case QLocale::Slovenian:
+        return Slovenian;
+    case QLocale::Somali:
+        return Somali;
+    case QLocale::Spanish:
+        return Spanish;
+    case QLocale::Sundanese:
+        return Sundanese;
+    case QLocale::Swahili:
+        return Swahili;
+    case QLocale::Swedish:
+        return Swedish;
+    case QLocale::Filipino:
+        return Filipino;
+    case QLocale::Tajik:
+        return Tajik;
+    case QLocale::Tamil:
+        return Tamil;
+    case QLocale::Tatar:
+        return Tatar;
+    case QLocale::Telugu:
+        return Telugu;
+    case QLocale::Thai:
+        return Thai;
+    case QLocale::Turkish:
+        return Turkish;
+    case QLocale::Turkmen:
+        return Turkmen;
+    case QLocale::Uighur:
+        return Uighur;
+    case QLocale::Ukrainian:
+        return Ukrainian;
+    case QLocale::Urdu:
+        return Urdu;
+    case QLocale::Uzbek:
+        return Uzbek;
+    case QLocale::Vietnamese:
+        return Vietnamese;
+    case QLocale::Welsh:
+        return Welsh;
+    case QLocale::Xhosa:
+        return Xhosa;
+    case QLocale::Yiddish:
+        return Yiddish;
+    case QLocale::Yoruba:
+        return Yoruba;
+    case QLocale::Zulu:
+        return Zulu;
+    default:
+        return English;
     }
 }
 
-void QOnlineTranslator::buildGoogleStateMachine()
-{
-    // States (Google sends translation, translit and dictionary in one request, that will be splitted into several by the translation limit)
-    auto *translationState = new QState(m_stateMachine);
-    auto *finalState = new QFinalState(m_stateMachine);
-    m_stateMachine->setInitialState(translationState);
-
-    translationState->addTransition(translationState, &QState::finished, finalState);
-
-    // Setup translation state
-    buildSplitNetworkRequest(translationState, &QOnlineTranslator::requestGoogleTranslate, &QOnlineTranslator::parseGoogleTranslate, m_source, s_googleTranslateLimit);
-}
-
-void QOnlineTranslator::buildGoogleDetectStateMachine()
-{
-    // States
-    auto *detectState = new QState(m_stateMachine);
-    auto *finalState = new QFinalState(m_stateMachine);
-    m_stateMachine->setInitialState(detectState);
-
-    detectState->addTransition(detectState, &QState::finished, finalState);
-
-    // Setup detect state
-    const QString text = m_source.left(getSplitIndex(m_source, s_googleTranslateLimit));
-    buildNetworkRequestState(detectState, &QOnlineTranslator::requestGoogleTranslate, &QOnlineTranslator::parseGoogleTranslate, text);
-}
-
-void QOnlineTranslator::buildYandexStateMachine()
-{
-    // States
-    auto *translationState = new QState(m_stateMachine);
-    auto *sourceTranslitState = new QState(m_stateMachine);
-    auto *translationTranslitState = new QState(m_stateMachine);
-    auto *dictionaryState = new QState(m_stateMachine);
-    auto *finalState = new QFinalState(m_stateMachine);
-    m_stateMachine->setInitialState(translationState);
-
-    // Transitions
-    translationState->addTransition(translationState, &QState::finished, sourceTranslitState);
-    sourceTranslitState->addTransition(sourceTranslitState, &QState::finished, translationTranslitState);
-    translationTranslitState->addTransition(translationTranslitState, &QState::finished, dictionaryState);
-    dictionaryState->addTransition(dictionaryState, &QState::finished, finalState);
-
-    // Setup translation state
-    buildSplitNetworkRequest(translationState, &QOnlineTranslator::requestYandexTranslate, &QOnlineTranslator::parseYandexTranslate, m_source, s_yandexTranslateLimit);
-
-    // Setup source translit state
-    if (m_sourceTranslitEnabled)
-        buildSplitNetworkRequest(sourceTranslitState, &QOnlineTranslator::requestYandexSourceTranslit, &QOnlineTranslator::parseYandexSourceTranslit, m_source, s_yandexTranslitLimit);
-    else
-        sourceTranslitState->setInitialState(new QFinalState(sourceTranslitState));
-
-    // Setup translation translit state
-    if (m_translationTranslitEnabled)
-        buildSplitNetworkRequest(translationTranslitState, &QOnlineTranslator::requestYandexTranslationTranslit, &QOnlineTranslator::parseYandexTranslationTranslit, m_translation, s_yandexTranslitLimit);
-    else
-        translationTranslitState->setInitialState(new QFinalState(translationTranslitState));
-
-    // Setup dictionary state
-    if (m_translationOptionsEnabled && !isContainsSpace(m_source))
-        buildNetworkRequestState(dictionaryState, &QOnlineTranslator::requestYandexDictionary, &QOnlineTranslator::parseYandexDictionary, m_source);
-    else
-        dictionaryState->setInitialState(new QFinalState(dictionaryState));
-}
-
-void QOnlineTranslator::buildYandexDetectStateMachine()
-{
-    // States
-    auto *detectState = new QState(m_stateMachine);
-    auto *finalState = new QFinalState(m_stateMachine);
-    m_stateMachine->setInitialState(detectState);
-
-    // Transitions
-    detectState->addTransition(detectState, &QState::finished, finalState);
-
-    // Setup detect state
-    const QString text = m_source.left(getSplitIndex(m_source, s_yandexTranslateLimit));
-    buildNetworkRequestState(detectState, &QOnlineTranslator::requestYandexTranslate, &QOnlineTranslator::parseYandexTranslate, text);
-}
-
-void QOnlineTranslator::buildBingStateMachine()
-{
-    // States
-    auto *credentialsState = new QState(m_stateMachine); // Generate credentials from web version first to access API
-    auto *translationState = new QState(m_stateMachine);
-    auto *dictionaryState = new QState(m_stateMachine);
-    auto *finalState = new QFinalState(m_stateMachine);
-    m_stateMachine->setInitialState(credentialsState);
-
-    // Transitions
-    credentialsState->addTransition(credentialsState, &QState::finished, translationState);
-    translationState->addTransition(translationState, &QState::finished, dictionaryState);
-    dictionaryState->addTransition(dictionaryState, &QState::finished, finalState);
-
-    // Setup credentials state
-    if (s_bingKey.isEmpty() || s_bingToken.isEmpty())
-        buildNetworkRequestState(credentialsState, &QOnlineTranslator::requestBingCredentials, &QOnlineTranslator::parseBingCredentials);
-    else
-        credentialsState->setInitialState(new QFinalState(credentialsState));
-
-    // Setup translation state
-    buildSplitNetworkRequest(translationState, &QOnlineTranslator::requestBingTranslate, &QOnlineTranslator::parseBingTranslate, m_source, s_bingTranslateLimit);
-
-    // Setup dictionary state
-    if (m_translationOptionsEnabled && !isContainsSpace(m_source))
-        buildNetworkRequestState(dictionaryState, &QOnlineTranslator::requestBingDictionary, &QOnlineTranslator::parseBingDictionary, m_source);
-    else
-        dictionaryState->setInitialState(new QFinalState(dictionaryState));
-}
-
-void QOnlineTranslator::buildBingDetectStateMachine()
-{
-    // States
-    auto *detectState = new QState(m_stateMachine);
-    auto *finalState = new QFinalState(m_stateMachine);
-    m_stateMachine->setInitialState(detectState);
-
-    detectState->addTransition(detectState, &QState::finished, finalState);
-
-    // Setup translation state
-    const QString text = m_source.left(getSplitIndex(m_source, s_bingTranslateLimit));
-    buildNetworkRequestState(detectState, &QOnlineTranslator::requestBingTranslate, &QOnlineTranslator::parseBingTranslate, text);
-}
-
-void QOnlineTranslator::buildLibreStateMachine()
-{
-    // States
-    auto *languageDetectionState = new QState(m_stateMachine);
-    auto *translationState = new QState(m_stateMachine);
-    auto *finalState = new QFinalState(m_stateMachine);
-    m_stateMachine->setInitialState(languageDetectionState);
-
-    // Transitions
-    languageDetectionState->addTransition(languageDetectionState, &QState::finished, translationState);
-    translationState->addTransition(translationState, &QState::finished, finalState);
-
-    // Setup LibreTranslate lang code detection
-    buildNetworkRequestState(languageDetectionState, &QOnlineTranslator::requestLibreLangDetection, &QOnlineTranslator::parseLibreLangDetection, m_source);
-
-    // Setup translation state
-    buildSplitNetworkRequest(translationState, &QOnlineTranslator::requestLibreTranslate, &QOnlineTranslator::parseLibreTranslate, m_source, s_libreTranslateLimit);
-}
-
-void QOnlineTranslator::buildLibreDetectStateMachine()
-{
-    // States
-    auto *detectState = new QState(m_stateMachine);
-    auto *finalState = new QFinalState(m_stateMachine);
-    m_stateMachine->setInitialState(detectState);
-
-    detectState->addTransition(detectState, &QState::finished, finalState);
-
-    // Setup lang detection state
-    const QString text = m_source.left(getSplitIndex(m_source, s_libreTranslateLimit));
-    buildNetworkRequestState(detectState, &QOnlineTranslator::requestLibreLangDetection, &QOnlineTranslator::parseLibreLangDetection, text);
-}
-
-void QOnlineTranslator::buildLingvaStateMachine()
-{
-    // States
-    auto *translationState = new QState(m_stateMachine);
-    auto *finalState = new QFinalState(m_stateMachine);
-    m_stateMachine->setInitialState(translationState);
-
-    // Transitions
-    translationState->addTransition(translationState, &QState::finished, finalState);
-
-    // Setup translation state
-    buildSplitNetworkRequest(translationState, &QOnlineTranslator::requestLingvaTranslate, &QOnlineTranslator::parseLingvaTranslate, m_source, s_googleTranslateLimit);
-}
-
-void QOnlineTranslator::buildLingvaDetectStateMachine()
-{
-    // States
-    auto *detectState = new QState(m_stateMachine);
-    auto *finalState = new QFinalState(m_stateMachine);
-    m_stateMachine->setInitialState(detectState);
-
-    detectState->addTransition(detectState, &QState::finished, finalState);
-
-    // Setup lang detection state
-    const QString text = m_source.left(getSplitIndex(m_source, s_googleTranslateLimit));
-    buildNetworkRequestState(detectState, &QOnlineTranslator::requestLingvaTranslate, &QOnlineTranslator::parseLingvaTranslate, text);
-}
-
-void QOnlineTranslator::buildSplitNetworkRequest(QState *parent, void (QOnlineTranslator::*requestMethod)(), void (QOnlineTranslator::*parseMethod)(), const QString &text, int textLimit)
+// Returns general language code
+QOnlineTranslator::Language QOnlineTranslator::language(const QString &langCode)
 {
-    QString unsendedText = text;
-    auto *nextTranslationState = new QState(parent);
-    parent->setInitialState(nextTranslationState);
-
-    while (!unsendedText.isEmpty()) {
-        auto *currentTranslationState = nextTranslationState;
-        nextTranslationState = new QState(parent);
-
-        // Do not translate the part if it looks like garbage
-        const int splitIndex = getSplitIndex(unsendedText, textLimit);
-        if (splitIndex == -1) {
-            currentTranslationState->setProperty(s_textProperty, unsendedText.left(textLimit));
-            currentTranslationState->addTransition(nextTranslationState);
-            connect(currentTranslationState, &QState::entered, this, &QOnlineTranslator::skipGarbageText);
-
-            // Remove the parsed part from the next parsing
-            unsendedText = unsendedText.mid(textLimit);
-        } else {
-            buildNetworkRequestState(currentTranslationState, requestMethod, parseMethod, unsendedText.left(splitIndex));
-            currentTranslationState->addTransition(currentTranslationState, &QState::finished, nextTranslationState);
-
-            // Remove the parsed part from the next parsing
-            unsendedText = unsendedText.mid(splitIndex);
-        }
-    }
-
-    nextTranslationState->addTransition(new QFinalState(parent));
+    return findLanguage(s_genericLanguageTable, langCode);
 }
 
-void QOnlineTranslator::buildNetworkRequestState(QState *parent, void (QOnlineTranslator::*requestMethod)(), void (QOnlineTranslator::*parseMethod)(), const QString &text)
+bool QOnlineTranslator::isSupportTranslation(Engine engine, Language lang)
 {
-    // Network substates
-    auto *requestingState = new QState(parent);
-    auto *parsingState = new QState(parent);
-
-    parent->setInitialState(requestingState);
-
-    // Substates transitions
-    requestingState->addTransition(m_networkManager, &QNetworkAccessManager::finished, parsingState);
-    parsingState->addTransition(new QFinalState(parent));
-
-    // Setup requesting state
-    requestingState->setProperty(s_textProperty, text);
-    connect(requestingState, &QState::entered, this, requestMethod);
-
-    // Setup parsing state
-    connect(parsingState, &QState::entered, this, parseMethod);
+    return isSupported(s_languageTables[engine].supportedLanguages, lang);
 }
 
-void QOnlineTranslator::requestYandexTranslit(Language language)
+QVector<QOnlineTranslator::Language> QOnlineTranslator::supportedLanguages(Engine engine)
 {
-    // Check if language is supported (need to check here because language may be autodetected)
-    if (!isSupportTranslit(Yandex, language)) {
-        auto *state = qobject_cast<QState *>(sender());
-        state->addTransition(new QFinalState(state->parentState()));
-        return;
-    }
-
-    const QString text = sender()->property(s_textProperty).toString();
-
-    // Generate API url
-    QUrl url(QStringLiteral("https://translate.yandex.net/translit/translit"));
-    url.setQuery("text=" + QUrl::toPercentEncoding(text)
-                 + "&lang=" + languageApiCode(Yandex, language));
-
-    m_currentReply = m_networkManager->get(QNetworkRequest(url));
+    return languages(s_languageTables[engine].supportedLanguages);
 }
 
-void QOnlineTranslator::parseYandexTranslit(QString &text)
+QVector<QOnlineTranslator::Language> QOnlineTranslator::supportedLanguages()
 {
-    m_currentReply->deleteLater();
-
-    if (m_currentReply->error() != QNetworkReply::NoError) {
-        resetData(NetworkError, m_currentReply->errorString());
-        return;
+    quint64 languagesBitset[s_languagesBitsetSize] = {};
+    for (const LanguageTable &table : s_languageTables) {
+        for (int i = 0; i < s_languagesBitsetSize; ++i)
+            languagesBitset[i] |= table.supportedLanguages[i];
     }
 
-    const QByteArray reply = m_currentReply->readAll();
-
-#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
-    text += reply.mid(1).chopped(1);
-#else
-    text += reply.mid(1);
-    text.chop(1);
-#endif
-}
-
-void QOnlineTranslator::resetData(TranslationError error, const QString &errorString)
-{
-    m_error = error;
-    m_errorString = errorString;
-    m_translation.clear();
-    m_translationTranslit.clear();
-    m_sourceTranslit.clear();
-    m_sourceTranscription.clear();
-    m_translationOptions.clear();
-    m_examples.clear();
-
-    m_stateMachine->stop();
-    for (QAbstractState *state : m_stateMachine->findChildren<QAbstractState *>()) {
-        if (!m_stateMachine->configuration().contains(state))
-            state->deleteLater();
-    }
+    return languages(languagesBitset);
 }
 
 bool QOnlineTranslator::isSupportTranslit(Engine engine, Language lang)
@@ -2381,70 +1727,53 @@ bool QOnlineTranslator::isSupportDictionary(Engine engine, Language sourceLang,
 // Returns engine-specific language code for translation
 QString QOnlineTranslator::languageApiCode(Engine engine, Language lang)
 {
-    if (!isSupportTranslation(engine, lang))
+    if (lang == NoLanguage)
         return {};
 
-    switch (engine) {
-    case Google:
-        return s_googleLanguageCodes.value(lang, s_genericLanguageCodes.value(lang));
-    case Yandex:
-        return s_yandexLanguageCodes.value(lang, s_genericLanguageCodes.value(lang));
-    case Bing:
-        return s_bingLanguageCodes.value(lang, s_genericLanguageCodes.value(lang));
-    case LibreTranslate:
-        return s_genericLanguageCodes.value(lang);
-    case Lingva:
-        return s_lingvaLanguageCodes.value(lang, s_genericLanguageCodes.value(lang));
-    }
-
-    Q_UNREACHABLE();
+    return QString::fromLatin1(s_languageTables[engine].codes[lang]);
 }
 
 // Parse language from response language code
 QOnlineTranslator::Language QOnlineTranslator::language(Engine engine, const QString &langCode)
 {
-    // Engine exceptions
-    switch (engine) {
-    case Google:
-        return s_googleLanguageCodes.key(langCode, s_genericLanguageCodes.key(langCode, NoLanguage));
-    case Yandex:
-        return s_yandexLanguageCodes.key(langCode, s_genericLanguageCodes.key(langCode, NoLanguage));
-    case Bing:
-        return s_bingLanguageCodes.key(langCode, s_genericLanguageCodes.key(langCode, NoLanguage));
-    case LibreTranslate:
-        return s_genericLanguageCodes.key(langCode, NoLanguage);
-    case Lingva:
-        return s_lingvaLanguageCodes.key(langCode, s_genericLanguageCodes.key(langCode, NoLanguage));
-    }
-
-    Q_UNREACHABLE();
+    return findLanguage(s_languageTables[engine], langCode);
 }
 
-// Get split index of the text according to the limit
-int QOnlineTranslator::getSplitIndex(const QString &untranslatedText, int limit)
+QOnlineTranslator::Language QOnlineTranslator::findLanguage(const LanguageTable &table, const QString &langCode)
 {
-    if (untranslatedText.size() < limit)
-        return limit;
+    const LanguageCode *begin = table.sortedCodes;
+    const LanguageCode *end = table.sortedCodes + table.sortedCodesCount;
+    const LanguageCode *it = std::lower_bound(begin, end, langCode, [](const LanguageCode &languageCode, const QString &langCode) {
+        return QLatin1String(languageCode.code) < langCode;
+    });
+
+    if (it == end || QLatin1String(it->code) != langCode)
+        return NoLanguage;
 
-    int splitIndex = untranslatedText.lastIndexOf(QLatin1String(". "), limit - 1);
-    if (splitIndex != -1)
-        return splitIndex + 1;
+    return it->lang;
+}
 
-    splitIndex = untranslatedText.lastIndexOf(' ', limit - 1);
-    if (splitIndex != -1)
-        return splitIndex + 1;
+bool QOnlineTranslator::isSupported(const quint64 *languagesBitset, Language lang)
+{
+    if (lang < Auto || lang >= s_languagesCount)
+        return false;
 
-    splitIndex = untranslatedText.lastIndexOf('\n', limit - 1);
-    if (splitIndex != -1)
-        return splitIndex + 1;
+    return (languagesBitset[lang / 64] >> (lang % 64)) & 1;
+}
 
-    // Non-breaking space
-    splitIndex = untranslatedText.lastIndexOf(0x00a0, limit - 1);
-    if (splitIndex != -1)
-        return splitIndex + 1;
+QVector<QOnlineTranslator::Language> QOnlineTranslator::languages(const quint64 *languagesBitset)
+{
+    QVector<Language> languages;
+    for (int i = 0; i < s_languagesBitsetSize; ++i) {
+        // Iterate over set bits only
+        for (quint64 bits = languagesBitset[i]; bits != 0; bits &= bits - 1) {
+            const int lang = i * 64 + qCountTrailingZeroBits(bits);
+            if (lang != Auto)
+                languages.append(static_cast<Language>(lang));
+        }
+    }
 
-    // If the text has not passed any check and is most likely garbage
-    return limit;
+    return languages;
 }
 
 bool QOnlineTranslator::isContainsSpace(const QString &text)
@@ -2467,3 +1796,18 @@ void QOnlineTranslator::addSpaceBetweenParts(QString &text)
         text.append(' ');
     }
 }
+
+int QOnlineTranslator::defaultChunkSize(Engine engine)
+{
+    switch (engine) {
+    case Yandex:
+        return s_yandexTranslateLimit;
+    case Bing:
+        return s_bingTranslateLimit;
+    case LibreTranslate:
+        return s_libreTranslateLimit;
+    default:
+        // Lingva proxies Google
+        return s_googleTranslateLimit;
+    }
+}
@@ -10,26 +10,37 @@
 
 #include "qexample.h"
 #include "qoption.h"
+#include "qrequesttiming.h"
 
+#include <QDateTime>
 #include <QMap>
+#include <QMutex>
 #include <QPointer>
 #include <QUuid>
 #include <QVector>
 
-class QStateMachine;
-class QState;
+class QOnlineBatchTranslationJob;
+class QOnlineTranslationCache;
+class QOnlineRequestScheduler;
+class QOnlineTranslationJob;
 class QNetworkAccessManager;
-class QNetworkReply;
+class QTimer;
 
 /**
  * @brief Provides translation data
+ *
+ * The translator and its jobs belong to the thread where they were created.
+ * Translators from different threads work independently and share only Bing credentials.
  */
 class QOnlineTranslator : public QObject
 {
     Q_OBJECT
     Q_DISABLE_COPY(QOnlineTranslator)
 
+    friend class QOnlineBatchTranslationJob;
+    friend class QOnlineTranslationJob;
     friend class QOnlineTts;
+    friend class QOnlineTranslatorTest; // Checks language tables and Bing credentials
 
 public:
     /**
@@ -223,6 +234,48 @@ public:
      */
     void detectLanguage(const QString &text, Engine engine = Google);
 
+    /**
+     * @brief Start translation in a separate job
+     *
+     * Unlike translate(), does not cancel previous operations, so several translations can run at the same time.
+     * Results are available from the returned job after its QOnlineTranslationJob::finished() signal.
+     * The job is a child of the translator, delete it with `deleteLater()` when it is no longer needed.
+     *
+     * @param text text to translate
+     * @param engine online engine to use
+     * @param translationLang language to translation
+     * @param sourceLang language of the passed text
+     * @param uiLang ui language to use for display
+     * @return started job
+     */
+    QOnlineTranslationJob *startTranslation(const QString &text, Engine engine = Google, Language translationLang = Auto, Language sourceLang = Auto, Language uiLang = Auto);
+
+    /**
+     * @brief Start translation of several texts in a separate job
+     *
+     * Texts are packed into as few requests as the engine limit allows, so translation of many short texts
+     * (like strings of an application) takes a few requests instead of a request per text.
+     * The job is a child of the translator, delete it with `deleteLater()` when it is no longer needed.
+     *
+     * @param texts texts to translate
+     * @param engine online engine to use
+     * @param translationLang language to translation
+     * @param sourceLang language of the passed texts
+     * @return started job
+     * @sa QOnlineBatchTranslationJob
+     */
+    QOnlineBatchTranslationJob *translateBatch(const QStringList &texts, Engine engine = Google, Language translationLang = Auto, Language sourceLang = Auto);
+
+    /**
+     * @brief Start language detection in a separate job
+     *
+     * @param text text for language detection
+     * @param engine engine to use
+     * @return started job
+     * @sa startTranslation()
+     */
+    QOnlineTranslationJob *startLanguageDetection(const QString &text, Engine engine = Google);
+
     /**
      * @brief Cancel translation operation (if any).
      */
@@ -321,6 +374,24 @@ public:
      */
     const QMap<QString, QVector<QExample>> &examples() const;
 
+    /**
+     * @brief Timings of network requests
+     *
+     * Empty if timings are disabled or the translation was taken from the cache.
+     *
+     * @return timings of each request in the order of sending
+     * @sa QRequestTiming, setTimingsEnabled()
+     */
+    const QVector<QRequestTiming> &timings() const;
+
+    /**
+     * @brief Number of repeated requests
+     *
+     * @return number of requests that were sent again after a network failure or timeout
+     * @sa setMaxRetries()
+     */
+    int retryCount() const;
+
     /**
      * @brief Last error
      *
@@ -415,11 +486,55 @@ public:
      */
     void setExamplesEnabled(bool enable);
 
+    /**
+     * @brief Check if request timings are enabled
+     *
+     * @return `true` if request timings are enabled
+     * @sa QRequestTiming
+     */
+    bool isTimingsEnabled() const;
+
+    /**
+     * @brief Enable or disable request timings
+     *
+     * Disabled by default. When enabled, timings and the number of retries are also included into toJson().
+     *
+     * @param enable whether to record timings of network requests
+     * @sa QRequestTiming
+     */
+    void setTimingsEnabled(bool enable);
+
+    /**
+     * @brief Check if incremental translation is enabled
+     *
+     * @return `true` if incremental translation is enabled
+     * @sa setIncrementalTranslationEnabled()
+     */
+    bool isIncrementalTranslationEnabled() const;
+
+    /**
+     * @brief Enable or disable incremental translation
+     *
+     * When enabled, texts are split into groups of sentences. If at least half of the groups are already cached,
+     * for example after translating the beginning of a text or editing a translated one, the groups are translated separately,
+     * so only missing groups are requested. Otherwise the text is translated as a whole with a single request.
+     * Groups are formed by the content of sentences, so editing a sentence changes only its group.
+     * Requires a cache to be set, disabled by default.
+     * Groups translated separately lose the context of each other.
+     *
+     * @param enable whether to enable incremental translation
+     * @sa setCache()
+     */
+    void setIncrementalTranslationEnabled(bool enable);
+
     /**
      * @brief Set the URL engine
      *
-     * Only affects LibreTranslate and Lingva because these engines have multiple instances.
-     * You need to call this function to specify the URL of an instance for them.
+     * LibreTranslate and Lingva have multiple instances,
+     * you need to call this function to specify the URL of an instance for them.
+     * For other engines the URL replaces the default host (scheme, host and port, without a path),
+     * for example to send requests through a proxy or to a local server that replays responses.
+     * Pass an empty URL to restore the default host. Yandex dictionary requests also use the Yandex URL.
      *
      * @param engine engine
      * @param url engine url
@@ -436,6 +551,259 @@ public:
      */
     void setEngineApiKey(Engine engine, QByteArray apiKey);
 
+    /**
+     * @brief Maximum number of concurrent requests for engine
+     *
+     * @param engine engine
+     * @return maximum number of concurrent requests
+     * @sa setEngineConcurrency()
+     */
+    int engineConcurrency(Engine engine) const;
+
+    /**
+     * @brief Set maximum number of concurrent requests for engine
+     *
+     * Engines have a limit of characters per request, so long texts are splitted into several parts.
+     * By default parts are sent one after another. With a limit greater than 1 up to the specified
+     * number of parts will be sent simultaneously. Results are still merged in the original order.
+     *
+     * @param engine engine
+     * @param concurrency maximum number of concurrent requests, 1 means sequential requests
+     */
+    void setEngineConcurrency(Engine engine, int concurrency);
+
+    /**
+     * @brief Response timeout for engine
+     *
+     * @param engine engine
+     * @return timeout in milliseconds, 0 if disabled
+     * @sa setEngineResponseTimeout()
+     */
+    int engineResponseTimeout(Engine engine) const;
+
+    /**
+     * @brief Set response timeout for engine
+     *
+     * Maximum time to wait for the response headers after sending a request.
+     * Includes DNS lookup, connection and processing of the request by the engine.
+     * Protects from unreachable hosts that would otherwise block until the system TCP timeout.
+     *
+     * @param engine engine
+     * @param msec timeout in milliseconds, 0 to disable
+     */
+    void setEngineResponseTimeout(Engine engine, int msec);
+
+    /**
+     * @brief Request timeout for engine
+     *
+     * @param engine engine
+     * @return timeout in milliseconds, 0 if disabled
+     * @sa setEngineTimeout()
+     */
+    int engineTimeout(Engine engine) const;
+
+    /**
+     * @brief Set request timeout for engine
+     *
+     * Maximum time of a whole request, including downloading of the response.
+     *
+     * @param engine engine
+     * @param msec timeout in milliseconds, 0 to disable
+     */
+    void setEngineTimeout(Engine engine, int msec);
+
+    /**
+     * @brief Maximum number of retries
+     *
+     * @return maximum number of retries for each request, 0 by default
+     * @sa setMaxRetries()
+     */
+    int maxRetries() const;
+
+    /**
+     * @brief Set maximum number of retries
+     *
+     * Requests that can be safely repeated (GET requests) are sent again after a network failure or timeout
+     * with a randomized delay. Errors of the engine are not retried.
+     *
+     * @param retries maximum number of retries for each request, 0 to disable
+     */
+    void setMaxRetries(int retries);
+
+    /**
+     * @brief Chunk size for engine
+     *
+     * @param engine engine
+     * @return maximum number of characters per translation request
+     * @sa setEngineChunkSize()
+     */
+    int engineChunkSize(Engine engine) const;
+
+    /**
+     * @brief Set chunk size for engine
+     *
+     * Longer texts are splitted into several requests by this size.
+     * By default the limit of the public instance of the engine is used,
+     * but self-hosted instances (see setEngineUrl()) can usually handle larger requests.
+     *
+     * @param engine engine
+     * @param size maximum number of characters per translation request, 0 to use the default size
+     * @sa setChunkSizeTuningEnabled()
+     */
+    void setEngineChunkSize(Engine engine, int size);
+
+    /**
+     * @brief Check if chunk size tuning is enabled
+     *
+     * @return `true` if chunk size tuning is enabled
+     * @sa setChunkSizeTuningEnabled()
+     */
+    bool isChunkSizeTuningEnabled() const;
+
+    /**
+     * @brief Enable or disable chunk size tuning
+     *
+     * Starting from engineChunkSize(), the size grows while the response time per character does not increase
+     * and shrinks when the response time increases, a request times out or the engine rejects it as too large.
+     * The size never grows beyond four times engineChunkSize().
+     * Tuned sizes are kept by the translator for next translations.
+     * Disabled by default.
+     *
+     * @param enable whether to tune chunk size
+     */
+    void setChunkSizeTuningEnabled(bool enable);
+
+    /**
+     * @brief Hedging engine
+     *
+     * @return engine
+     * @sa setHedgingEngine()
+     */
+    Engine hedgingEngine() const;
+
+    /**
+     * @brief Set hedging engine
+     *
+     * If hedging is enabled and a translation takes longer than hedgingDelay(), the same translation is also requested from this engine.
+     * The first successful result is used and requests of the other engine are aborted.
+     * The engine is also used immediately if the main engine fails.
+     * Has no effect when the main engine is the same.
+     *
+     * @param engine secondary engine
+     * @sa setHedgingDelay()
+     */
+    void setHedgingEngine(Engine engine);
+
+    /**
+     * @brief Hedging delay
+     *
+     * @return delay in milliseconds, 0 if disabled
+     * @sa setHedgingDelay()
+     */
+    int hedgingDelay() const;
+
+    /**
+     * @brief Set hedging delay
+     *
+     * Time to wait for the main engine before sending requests to hedgingEngine().
+     * Usually it's the 95th percentile of the main engine response time, so only slowest translations are duplicated.
+     * Disabled by default.
+     *
+     * @param msec delay in milliseconds, 0 to disable
+     */
+    void setHedgingDelay(int msec);
+
+    /**
+     * @brief Minimum confidence of offline language detection
+     *
+     * @return confidence from 0 to 1
+     * @sa setOfflineDetectionThreshold()
+     */
+    double offlineDetectionThreshold() const;
+
+    /**
+     * @brief Set minimum confidence of offline language detection
+     *
+     * Language detection first tries to identify the language locally with QLanguageIdentifier.
+     * If the confidence of the result is not lower than the threshold, no requests will be sent to the engine.
+     * The default threshold is high enough to send requests for short texts and languages without built-in profiles.
+     *
+     * @param threshold confidence from 0 to 1, a value greater than 1 disables offline detection
+     * @sa QLanguageIdentifier
+     */
+    void setOfflineDetectionThreshold(double threshold);
+
+    /**
+     * @brief Translation results cache
+     *
+     * @return cache or `nullptr` if caching is disabled
+     * @sa setCache()
+     */
+    QOnlineTranslationCache *cache() const;
+
+    /**
+     * @brief Set translation results cache
+     *
+     * Successful translation results will be stored in the cache.
+     * If the same text was already translated with the same engine, languages and enabled features,
+     * the result will be taken from the cache without sending requests.
+     * The object does not take ownership of the cache.
+     *
+     * @param cache cache to use or `nullptr` to disable caching
+     */
+    void setCache(QOnlineTranslationCache *cache);
+
+    /**
+     * @brief Request scheduler
+     *
+     * @return scheduler or `nullptr` if requests are not limited
+     * @sa setScheduler()
+     */
+    QOnlineRequestScheduler *scheduler() const;
+
+    /**
+     * @brief Set request scheduler
+     *
+     * All requests of translations will be sent through the scheduler to respect limits of engines.
+     * The same scheduler can be shared between several translators.
+     * The object does not take ownership of the scheduler.
+     *
+     * @param scheduler scheduler to use or `nullptr` to send requests immediately
+     */
+    void setScheduler(QOnlineRequestScheduler *scheduler);
+
+    /**
+     * @brief Open connections to engine hosts in advance
+     *
+     * Performs DNS lookup, TCP and TLS handshakes, so the next translation with this engine will not wait for them.
+     * Does nothing for hosts that already have an open connection.
+     * Call it when a translation is likely to be requested soon, for example when a window appears.
+     *
+     * @param engine engine
+     * @sa setKeepAliveInterval()
+     */
+    void warmUp(Engine engine);
+
+    /**
+     * @brief Keep-alive interval
+     *
+     * @return interval in milliseconds, 0 if disabled
+     * @sa setKeepAliveInterval()
+     */
+    int keepAliveInterval() const;
+
+    /**
+     * @brief Set keep-alive interval
+     *
+     * Servers close idle connections after some time.
+     * If enabled, connections to hosts of the engine from the last warmUp() call will be re-opened periodically.
+     * Nothing is kept alive until warmUp() is called.
+     * Disabled by default.
+     *
+     * @param msec interval in milliseconds, 0 to disable
+     */
+    void setKeepAliveInterval(int msec);
+
     /**
      * @brief Language name
      *
@@ -477,6 +845,21 @@ public:
      */
     static bool isSupportTranslation(Engine engine, Language lang);
 
+    /**
+     * @brief Languages supported by engine
+     *
+     * @param engine engine
+     * @return languages in the order of declaration, without QOnlineTranslator::Auto
+     */
+    static QVector<Language> supportedLanguages(Engine engine);
+
+    /**
+     * @brief Languages supported by at least one engine
+     *
+     * @return languages in the order of declaration, without QOnlineTranslator::Auto
+     */
+    static QVector<Language> supportedLanguages();
+
 signals:
     /**
      * @brief Translation finished
@@ -485,76 +868,38 @@ signals:
      */
     void finished();
 
-private slots:
-    void skipGarbageText();
-
-    // Google
-    void requestGoogleTranslate();
-    void parseGoogleTranslate();
-
-    void requestYandexTranslate();
-    void parseYandexTranslate();
-
-    void requestYandexSourceTranslit();
-    void parseYandexSourceTranslit();
-
-    void requestYandexTranslationTranslit();
-    void parseYandexTranslationTranslit();
-
-    void requestYandexDictionary();
-    void parseYandexDictionary();
-
-    // Bing
-    void requestBingCredentials();
-    void parseBingCredentials();
-
-    void requestBingTranslate();
-    void parseBingTranslate();
-
-    void requestBingDictionary();
-    void parseBingDictionary();
-
-    // LibreTranslate
-    void requestLibreLangDetection();
-    void parseLibreLangDetection();
-
-    void requestLibreTranslate();
-    void parseLibreTranslate();
-
-    // Lingva
-    void requestLingvaTranslate();
-    void parseLingvaTranslate();
-
-private:
-    /*
-     * Engines have translation limit, so need to split all text into parts and make request sequentially.
-     * Also Yandex and Bing requires several requests to get dictionary, transliteration etc.
-     * We use state machine to rely async computation with signals and slots.
+    /**
+     * @brief Part of the translation is available
+     *
+     * Long texts are translated in several parts, this signal is called after each part is received,
+     * so the translation can be displayed before the whole text is translated.
+     * At this moment translation() returns all parts received so far.
+     *
+     * @param offset position of the part in translation()
+     * @param text translation of the part
      */
-    void buildGoogleStateMachine();
-    void buildGoogleDetectStateMachine();
-
-    void buildYandexStateMachine();
-    void buildYandexDetectStateMachine();
-
-    void buildBingStateMachine();
-    void buildBingDetectStateMachine();
+    void partialTranslationAvailable(int offset, const QString &text);
 
-    void buildLibreStateMachine();
-    void buildLibreDetectStateMachine();
-
-    void buildLingvaStateMachine();
-    void buildLingvaDetectStateMachine();
+private:
+    static constexpr int s_languagesCount = Zulu + 1;
+    static constexpr int s_languagesBitsetSize = (s_languagesCount + 63) / 64;
+    static constexpr int s_enginesCount = Lingva + 1;
 
-    // Helper functions to build nested states
-    void buildSplitNetworkRequest(QState *parent, void (QOnlineTranslator::*requestMethod)(), void (QOnlineTranslator::*parseMethod)(), const QString &text, int textLimit);
-    void buildNetworkRequestState(QState *parent, void (QOnlineTranslator::*requestMethod)(), void (QOnlineTranslator::*parseMethod)(), const QString &text = {});
+    struct LanguageCode {
+        Language lang = NoLanguage;
+        const char *code = nullptr;
+    };
 
-    // Helper functions for transliteration
-    void requestYandexTranslit(Language language);
-    void parseYandexTranslit(QString &text);
+    // Lookup structures of an engine that are generated at compile time
+    struct LanguageTable {
+        const char *codes[s_languagesCount] = {}; // Indexed by language, nullptr if not supported
+        LanguageCode sortedCodes[s_languagesCount * 2] = {}; // Sorted by code for binary search
+        int sortedCodesCount = 0;
+        quint64 supportedLanguages[s_languagesBitsetSize] = {};
+    };
 
-    void resetData(TranslationError error = NoError, const QString &errorString = {});
+    void resetJob();
+    void openConnections(Engine engine);
 
     // Check for service support
     static bool isSupportTranslit(Engine engine, Language lang);
@@ -563,69 +908,100 @@ private:
     // Other
     static QString languageApiCode(Engine engine, Language lang);
     static Language language(Engine engine, const QString &langCode);
-    static int getSplitIndex(const QString &untranslatedText, int limit);
+    static Language findLanguage(const LanguageTable &table, const QString &langCode);
+    static bool isSupported(const quint64 *languagesBitset, Language lang);
+    static QVector<Language> languages(const quint64 *languagesBitset);
     static bool isContainsSpace(const QString &text);
     static void addSpaceBetweenParts(QString &text);
+    static int defaultChunkSize(Engine engine);
 
-    static const QMap<Language, QString> s_genericLanguageCodes;
+    // Helpers to generate language tables
+    static constexpr bool isSupportTranslationByEngine(Engine engine, Language lang);
+    static constexpr LanguageTable languageTable(const LanguageCode *engineCodes, int engineCodesCount);
+    static constexpr LanguageTable languageTable(Engine engine, const LanguageCode *engineCodes, int engineCodesCount);
+    static constexpr void addLanguageCode(LanguageTable &table, LanguageCode languageCode);
+    static constexpr int compareCodes(const char *first, const char *second);
+
+    static const LanguageCode s_genericLanguageCodes[];
 
     // Engines have some language codes exceptions
-    static const QMap<Language, QString> s_googleLanguageCodes;
-    static const QMap<Language, QString> s_yandexLanguageCodes;
-    static const QMap<Language, QString> s_bingLanguageCodes;
-    static const QMap<Language, QString> s_lingvaLanguageCodes;
+    static const LanguageCode s_googleLanguageCodes[];
+    static const LanguageCode s_yandexLanguageCodes[];
+    static const LanguageCode s_bingLanguageCodes[];
+    static const LanguageCode s_lingvaLanguageCodes[];
+
+    static const LanguageTable s_genericLanguageTable;
+    static const LanguageTable s_languageTables[s_enginesCount];
 
-    // Yandex require a random UUID to be generated
-    static inline QByteArray s_yandexUcid = QUuid::createUuid().toByteArray(QUuid::Id128);
+    // Yandex require a random UUID to be generated.
+    // Each thread has its own one, since it's cleared after errors
+    static inline thread_local QByteArray s_yandexUcid = QUuid::createUuid().toByteArray(QUuid::Id128);
 
-    // Credentials that is parsed from the web version to receive the translation using the API
+    // Credentials that is parsed from the web version to receive the translation using the API.
+    // Saved to disk to reuse them in other processes until expiration, guarded by the mutex for translators in other threads
+    static inline QMutex s_bingCredentialsMutex;
     static inline QByteArray s_bingKey;
     static inline QByteArray s_bingToken;
     static inline QString s_bingIg;
     static inline QString s_bingIid;
-
-    // This properties used to store unseful information in states
-    static constexpr char s_textProperty[] = "Text";
+    static inline QDateTime s_bingExpiration;
 
     // Engines have a limit of characters per translation request.
-    // If the query is larger, then it should be splited into several with getSplitIndex() helper function
+    // If the query is larger, then it should be splited into several with QTextSegmenter
     static constexpr int s_googleTranslateLimit = 5000;
     static constexpr int s_yandexTranslateLimit = 150;
     static constexpr int s_yandexTranslitLimit = 180;
     static constexpr int s_bingTranslateLimit = 502;
     static constexpr int s_libreTranslateLimit = 120;
 
-    QStateMachine *m_stateMachine;
-    QNetworkAccessManager *m_networkManager;
-    QPointer<QNetworkReply> m_currentReply;
-
-    Language m_sourceLang = NoLanguage;
-    Language m_translationLang = NoLanguage;
-    Language m_uiLang = NoLanguage;
-    TranslationError m_error = NoError;
+    static constexpr double s_defaultOfflineDetectionThreshold = 0.9;
+    static constexpr int s_defaultResponseTimeout = 10000;
+    static constexpr int s_defaultTimeout = 30000;
+    static constexpr int s_defaultMaxRetries = 0;
 
-    QString m_source;
-    QString m_sourceTranslit;
-    QString m_sourceTranscription;
-    QString m_translation;
-    QString m_translationTranslit;
-    QString m_errorString;
+    QNetworkAccessManager *m_networkManager;
+    QOnlineTranslationJob *m_job; // Used by single-shot API
+    QPointer<QOnlineTranslationCache> m_cache;
+    QPointer<QOnlineRequestScheduler> m_scheduler;
+    QTimer *m_keepAliveTimer;
+    Engine m_warmUpEngine = Google;
+    bool m_warmedUp = false;
+    int m_keepAliveInterval = 0;
 
     // Self-hosted engines settings
     QByteArray m_libreApiKey; // Can be empty, since free instances ignores api_key param
     QString m_libreUrl;
     QString m_lingvaUrl;
 
-    QMap<QString, QVector<QOption>> m_translationOptions;
-    QMap<QString, QVector<QExample>> m_examples;
+    // Replace default hosts of other engines if not empty
+    QString m_googleUrl;
+    QString m_yandexUrl;
+    QString m_bingUrl;
+
+    QMap<Engine, int> m_engineConcurrency;
+    QMap<Engine, int> m_engineResponseTimeouts;
+    QMap<Engine, int> m_engineTimeouts;
+    int m_maxRetries = s_defaultMaxRetries;
+    QMap<Engine, int> m_engineChunkSizes;
+    Engine m_hedgingEngine = Bing;
+    int m_hedgingDelay = 0;
+    double m_offlineDetectionThreshold = s_defaultOfflineDetectionThreshold;
 
     bool m_sourceTranslitEnabled = true;
     bool m_translationTranslitEnabled = true;
     bool m_sourceTranscriptionEnabled = true;
     bool m_translationOptionsEnabled = true;
     bool m_examplesEnabled = true;
-
-    bool m_onlyDetectLanguage = false;
+    bool m_timingsEnabled = false;
+    bool m_incrementalTranslationEnabled = false;
+    bool m_chunkSizeTuningEnabled = false;
+
+    // Chunk size tuning state, shared by all jobs of the translator
+    struct ChunkSizeTuning {
+        int size = 0;
+        double latency = 0; // Average milliseconds per character of full parts
+    };
+    QMap<Engine, ChunkSizeTuning> m_chunkSizeTuning;
 };
 
 #endif // QONLINETRANSLATOR_H
@@ -6,6 +6,7 @@
  */
 
 #include "qonlinetts.h"
+#include "qtextsegmenter.h"
 
 #include <QMetaEnum>
 #include <QUrl>
@@ -57,7 +58,6 @@ QOnlineTts::QOnlineTts(QObject *parent)
 void QOnlineTts::generateUrls(const QString &text, QOnlineTranslator::Engine engine, QOnlineTranslator::Language lang, Voice voice, Emotion emotion)
 {
     // Get speech
-    QString unparsedText = text;
     switch (engine) {
     case QOnlineTranslator::Google: {
         if (voice != NoVoice) {
@@ -75,17 +75,15 @@ void QOnlineTts::generateUrls(const QString &text, QOnlineTranslator::Engine eng
             return;
 
         // Google has a limit of characters per tts request. If the query is larger, then it should be splited into several
-        while (!unparsedText.isEmpty()) {
-            const int splitIndex = QOnlineTranslator::getSplitIndex(unparsedText, s_googleTtsLimit); // Split the part by special symbol
+        QTextSegmenter segmenter(text, s_googleTtsLimit);
+        while (!segmenter.atEnd()) {
+            const QTextSegmenter::Segment segment = segmenter.next();
 
             // Generate URL API for add it to the playlist
             QUrl apiUrl(QStringLiteral("https://translate.googleapis.com/translate_tts"));
-            const QString query = QStringLiteral("ie=UTF-8&client=gtx&tl=%1&q=%2").arg(langString, QString(QUrl::toPercentEncoding(unparsedText.left(splitIndex))));
+            const QString query = QStringLiteral("ie=UTF-8&client=gtx&tl=%1&q=%2").arg(langString, QString(QUrl::toPercentEncoding(text.mid(segment.offset, segment.length))));
             apiUrl.setQuery(query);
             m_media.append(apiUrl);
-
-            // Remove the said part from the next saying
-            unparsedText = unparsedText.mid(splitIndex);
         }
         break;
     }
@@ -103,18 +101,16 @@ void QOnlineTts::generateUrls(const QString &text, QOnlineTranslator::Engine eng
             return;
 
         // Yandex has a limit of characters per tts request. If the query is larger, then it should be splited into several
-        while (!unparsedText.isEmpty()) {
-            const int splitIndex = QOnlineTranslator::getSplitIndex(unparsedText, s_yandexTtsLimit); // Split the part by special symbol
+        QTextSegmenter segmenter(text, s_yandexTtsLimit);
+        while (!segmenter.atEnd()) {
+            const QTextSegmenter::Segment segment = segmenter.next();
 
             // Generate URL API for add it to the playlist
             QUrl apiUrl(QStringLiteral("https://tts.voicetech.yandex.net/tts"));
             const QString query = QStringLiteral("text=%1&lang=%2&speaker=%3&emotion=%4&format=mp3")
-                                      .arg(QUrl::toPercentEncoding(unparsedText.left(splitIndex)), langString, voiceString, emotionString);
+                                      .arg(QUrl::toPercentEncoding(text.mid(segment.offset, segment.length)), langString, voiceString, emotionString);
             apiUrl.setQuery(query);
             m_media.append(apiUrl);
-
-            // Remove the said part from the next saying
-            unparsedText = unparsedText.mid(splitIndex);
         }
         break;
     }
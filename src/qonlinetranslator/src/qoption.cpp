@@ -20,3 +20,16 @@ QJsonObject QOption::toJson() const
 
     return object;
 }
+
+QOption QOption::fromJson(const QJsonObject &object)
+{
+    QOption option;
+    option.word = object.value(QStringLiteral("word")).toString();
+    option.gender = object.value(QStringLiteral("gender")).toString();
+    const QJsonArray translations = object.value(QStringLiteral("translations")).toArray();
+    option.translations.reserve(translations.size());
+    for (const QJsonValue &translation : translations)
+        option.translations.append(translation.toString());
+
+    return option;
+}
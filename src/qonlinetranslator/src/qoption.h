@@ -72,6 +72,14 @@ struct QOption {
      * @return JSON representation
      */
     QJsonObject toJson() const;
+
+    /**
+     * @brief Creates the object from JSON
+     *
+     * @param object JSON representation
+     * @return translation option
+     */
+    static QOption fromJson(const QJsonObject &object);
 };
 
 #endif // QOPTION_H
@@ -0,0 +1,24 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "qrequesttiming.h"
+
+QJsonObject QRequestTiming::toJson() const
+{
+    QJsonObject object{
+        {"connection", connection},
+        {"download", download},
+        {"firstByte", firstByte},
+        {"parsing", parsing},
+        {"part", part},
+        {"queued", queued},
+        {"size", size},
+        {"url", url},
+    };
+
+    return object;
+}
@@ -0,0 +1,82 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef QREQUESTTIMING_H
+#define QREQUESTTIMING_H
+
+#include <QJsonObject>
+#include <QString>
+
+/**
+ * @brief Contains timings of a single network request of the translation
+ *
+ * Can be obtained from the QOnlineTranslator object if timings are enabled.
+ * All durations are in milliseconds, -1 means that the phase did not happen.
+ *
+ * Example:
+ * @code
+ * QOnlineTranslator translator;
+ * translator.setTimingsEnabled(true);
+ * // Obtain translation
+ *
+ * QTextStream out(stdout);
+ * for (const QRequestTiming &timing : translator.timings())
+ *     out << timing.url << ": " << timing.firstByte << " ms to first byte" << endl;
+ * @endcode
+ */
+struct QRequestTiming {
+    /**
+     * @brief Requested URL without query.
+     */
+    QString url;
+
+    /**
+     * @brief Index of the text part, engines have translation limits, so long texts are sent in parts.
+     */
+    int part = 0;
+
+    /**
+     * @brief Time the request waited for the request scheduler.
+     */
+    qint64 queued = 0;
+
+    /**
+     * @brief Time from sending to the end of TLS handshake, includes host lookup and TCP connection.
+     *
+     * Only available for new encrypted connections, reused connections are -1.
+     */
+    qint64 connection = -1;
+
+    /**
+     * @brief Time from sending to the first byte of the response.
+     */
+    qint64 firstByte = -1;
+
+    /**
+     * @brief Time from the first byte to the end of the response.
+     */
+    qint64 download = -1;
+
+    /**
+     * @brief Time of parsing the response.
+     */
+    qint64 parsing = -1;
+
+    /**
+     * @brief Size of the response in bytes.
+     */
+    qint64 size = 0;
+
+    /**
+     * @brief Converts the object to JSON
+     *
+     * @return JSON representation
+     */
+    QJsonObject toJson() const;
+};
+
+#endif // QREQUESTTIMING_H
@@ -0,0 +1,148 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "qtextsegmenter.h"
+
+QTextSegmenter::QTextSegmenter(const QString &text, int limit)
+    : m_text(text)
+    , m_limit(qMax(1, limit))
+    , m_atEnd(text.isEmpty())
+{
+}
+
+bool QTextSegmenter::atEnd() const
+{
+    return m_atEnd;
+}
+
+QTextSegmenter::Segment QTextSegmenter::next()
+{
+    const int remaining = m_text.size() - m_offset;
+    if (remaining <= m_limit) {
+        const Segment segment{m_offset, remaining};
+        m_offset = m_text.size();
+        m_atEnd = true;
+        return segment;
+    }
+
+    // Continue scanning from the previous part end, breaks after the previous split are still valid
+    const int end = m_offset + m_limit;
+    for (; m_position < end; ++m_position) {
+        const BreakType type = breakType(m_position);
+        if (type != NoBreak)
+            m_breaks[type] = m_position + 1;
+    }
+
+    // Prefer the most important break, but avoid too small parts since each part is a separate request
+    int splitIndex = -1;
+    for (int type = BreakTypesCount - 1; type >= 0; --type) {
+        if (m_breaks[type] > m_offset + m_limit / 2) {
+            splitIndex = m_breaks[type];
+            break;
+        }
+    }
+
+    if (splitIndex == -1) {
+        for (int breakIndex : m_breaks)
+            splitIndex = qMax(splitIndex, breakIndex);
+    }
+
+    if (splitIndex <= m_offset) {
+        // No breaks, cut at the limit, but do not split surrogate pairs
+        splitIndex = end;
+        if (m_text.at(end - 1).isHighSurrogate() && end - 1 > m_offset)
+            --splitIndex;
+    }
+
+    const Segment segment{m_offset, splitIndex - m_offset};
+    m_offset = splitIndex;
+    return segment;
+}
+
+QVector<QTextSegmenter::Segment> QTextSegmenter::split(const QString &text, int limit)
+{
+    QVector<Segment> segments;
+    segments.reserve(text.size() / qMax(1, limit) + 1);
+
+    QTextSegmenter segmenter(text, limit);
+    while (!segmenter.atEnd())
+        segments.append(segmenter.next());
+
+    return segments;
+}
+
+QTextSegmenter::BreakType QTextSegmenter::breakType(int index) const
+{
+    const QChar symbol = m_text.at(index);
+    if (isSentenceTerminator(symbol))
+        return SentenceBreak;
+
+    if (symbol == '\n' || symbol == QChar::ParagraphSeparator || symbol == QChar::LineSeparator)
+        return LineBreak;
+
+    if (symbol == QChar::Nbsp)
+        return NonBreakingSpaceBreak;
+
+    if (!symbol.isSpace())
+        return NoBreak;
+
+    if (index != 0) {
+        // Thai has no sentence punctuation and uses spaces to separate sentences
+        const QChar previous = m_text.at(index - 1);
+        if (isSpacedSentenceTerminator(previous) || isThai(previous))
+            return SentenceBreak;
+    }
+
+    return SpaceBreak;
+}
+
+// Punctuation that ends a sentence without a following space
+bool QTextSegmenter::isSentenceTerminator(QChar symbol)
+{
+    switch (symbol.unicode()) {
+    case 0x0589: // Armenian full stop
+    case 0x061F: // Arabic question mark
+    case 0x06D4: // Arabic full stop
+    case 0x0964: // Devanagari danda
+    case 0x0965: // Devanagari double danda
+    case 0x0E5A: // Thai angkhankhu
+    case 0x0E5B: // Thai khomut
+    case 0x0F0D: // Tibetan shad
+    case 0x104A: // Myanmar little section
+    case 0x104B: // Myanmar section
+    case 0x1362: // Ethiopic full stop
+    case 0x17D4: // Khmer khan
+    case 0x3002: // CJK ideographic full stop
+    case 0xFF01: // Fullwidth exclamation mark
+    case 0xFF0E: // Fullwidth full stop
+    case 0xFF1F: // Fullwidth question mark
+    case 0xFF61: // Halfwidth ideographic full stop
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Punctuation that ends a sentence only when followed by a space
+bool QTextSegmenter::isSpacedSentenceTerminator(QChar symbol)
+{
+    switch (symbol.unicode()) {
+    case '.':
+    case '!':
+    case '?':
+    case ';':
+    case 0x2026: // Horizontal ellipsis
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool QTextSegmenter::isThai(QChar symbol)
+{
+    return symbol.unicode() >= 0x0E00 && symbol.unicode() <= 0x0E7F;
+}
@@ -0,0 +1,102 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef QTEXTSEGMENTER_H
+#define QTEXTSEGMENTER_H
+
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief Splits text into parts that fit into a length limit
+ *
+ * Walks the text only once and returns parts as positions in the original text without copying it.
+ * The text is split after sentence punctuation of different scripts (including CJK, Thai, Devanagari and Arabic) when possible,
+ * then after line breaks and spaces. A part without any of these symbols is cut at the limit.
+ * Parts cover the whole text, so joining them gives the original text.
+ *
+ * Example:
+ * @code
+ * QTextSegmenter segmenter(text, 200);
+ * while (!segmenter.atEnd()) {
+ *     const QTextSegmenter::Segment segment = segmenter.next();
+ *     qInfo() << text.mid(segment.offset, segment.length);
+ * }
+ * @endcode
+ */
+class QTextSegmenter
+{
+public:
+    /**
+     * @brief Part of the text
+     */
+    struct Segment {
+        int offset = 0;
+        int length = 0;
+    };
+
+    /**
+     * @brief Create object
+     *
+     * The text is not copied and should outlive the segmenter.
+     *
+     * @param text text to split
+     * @param limit maximum length of a part
+     */
+    QTextSegmenter(const QString &text, int limit);
+
+    /**
+     * @brief Check for remaining parts
+     *
+     * @return `true` when the whole text has been returned by next()
+     */
+    bool atEnd() const;
+
+    /**
+     * @brief Next part
+     *
+     * Returns empty part for empty text.
+     *
+     * @return position of the next part in the text
+     */
+    Segment next();
+
+    /**
+     * @brief Split the whole text
+     *
+     * @param text text to split
+     * @param limit maximum length of a part
+     * @return positions of all parts in the text
+     */
+    static QVector<Segment> split(const QString &text, int limit);
+
+private:
+    // Ordered by priority
+    enum BreakType {
+        NoBreak = -1,
+        NonBreakingSpaceBreak,
+        SpaceBreak,
+        LineBreak,
+        SentenceBreak,
+        BreakTypesCount
+    };
+
+    BreakType breakType(int index) const;
+
+    static bool isSentenceTerminator(QChar symbol);
+    static bool isSpacedSentenceTerminator(QChar symbol);
+    static bool isThai(QChar symbol);
+
+    const QString &m_text;
+    int m_limit;
+    int m_offset = 0;
+    int m_position = 0; // Symbols before this position are already scanned
+    int m_breaks[BreakTypesCount] = {}; // Last split position for each break type
+    bool m_atEnd = false;
+};
+
+#endif // QTEXTSEGMENTER_H
@@ -0,0 +1,186 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "enginepayloads.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <iterator>
+
+QByteArray EnginePayloads::google(const QString &text, bool full)
+{
+    return googleBlocks(text, GoogleTranslation | GoogleTranslit | (full ? GoogleDictionary | GoogleDefinitions : 0));
+}
+
+QByteArray EnginePayloads::googleBlocks(const QString &text, int blocks)
+{
+    const bool isWord = !text.contains(' ');
+    const QStringList textSentences = sentences(text);
+
+    // Sentences are followed by the transliteration block
+    QJsonArray sentencesData;
+    for (const QString &sentence : textSentences)
+        sentencesData.append(QJsonArray{sentence, sentence, QJsonValue(), QJsonValue(), 3});
+    if (blocks & GoogleTranslit)
+        sentencesData.append(QJsonArray{QJsonValue(), QJsonValue(), text, text});
+
+    QJsonArray options;
+    QJsonArray definitions;
+    QJsonArray synonyms;
+    QJsonArray examples;
+
+    // Dictionary blocks have data only for words
+    if (isWord) {
+        for (const char *typeOfSpeech : s_typesOfSpeech) {
+            QJsonArray words;
+            QJsonArray typeDefinitions;
+            QJsonArray typeSynonyms;
+            for (int i = 0; i < s_fullDictionaryWords; ++i) {
+                QJsonArray meanings;
+                for (int j = 0; j < s_fullDictionaryMeanings; ++j)
+                    meanings.append(word(i + j));
+                words.append(QJsonArray{word(i), meanings, QJsonValue(), 0.1, QStringLiteral("die")});
+                typeSynonyms.append(QJsonArray{meanings, QStringLiteral("m_en_gbus0001")});
+            }
+            for (int i = 0; i < s_fullDictionaryExamples; ++i) {
+                typeDefinitions.append(QJsonArray{paragraph(60), QStringLiteral("m_en_gbus0001"), paragraph(40)});
+                examples.append(QJsonArray{paragraph(40), QJsonValue(), QJsonValue(), QJsonValue(), QJsonValue(), QStringLiteral("m_en_gbus0001")});
+            }
+
+            if (blocks & GoogleDictionary)
+                options.append(QJsonArray{typeOfSpeech, QJsonArray(), words, text, 1});
+            if (blocks & GoogleDefinitions)
+                definitions.append(QJsonArray{typeOfSpeech, typeDefinitions, text});
+            synonyms.append(QJsonArray{typeOfSpeech, typeSynonyms, text});
+        }
+    }
+
+    QJsonArray response{sentencesData, options, QStringLiteral("en")};
+    while (response.size() < 12)
+        response.append(QJsonValue());
+    response.append(definitions);
+
+    if (blocks & GoogleUnparsed) {
+        // Alternative translations for each sentence
+        QJsonArray alternatives;
+        for (const QString &sentence : textSentences) {
+            QJsonArray sentenceAlternatives;
+            for (int i = 0; i < 3; ++i)
+                sentenceAlternatives.append(QJsonArray{sentence, 0, true, false});
+            alternatives.append(QJsonArray{sentence, QJsonValue(), sentenceAlternatives, QJsonArray{QJsonValue(QJsonArray{0, sentence.size()})}, sentence, 0, 0});
+        }
+        response[5] = alternatives;
+        response[8] = QJsonArray{QJsonArray{QStringLiteral("en")}, QJsonValue(), QJsonArray{1}, QJsonArray{QStringLiteral("en")}};
+        if (isWord) {
+            response[11] = synonyms;
+            response.append(QJsonArray{QJsonValue(examples)});
+            response.append(QJsonArray{QJsonValue(QJsonArray{word(1), word(2), word(3)})});
+        }
+    }
+
+    return QJsonDocument(response).toJson(QJsonDocument::Compact);
+}
+
+QByteArray EnginePayloads::yandexDictionary(const QString &text, bool full)
+{
+    const int typesOfSpeech = full ? static_cast<int>(std::size(s_typesOfSpeech)) : 1;
+    const int words = full ? s_fullDictionaryWords : 2;
+    const int meanings = full ? s_fullDictionaryMeanings : 1;
+    const int examples = full ? s_fullDictionaryExamples : 0;
+
+    QJsonArray regular;
+    for (int type = 0; type < typesOfSpeech; ++type) {
+        QJsonArray translations;
+        for (int i = 0; i < words; ++i) {
+            QJsonArray meaningsData;
+            for (int j = 0; j < meanings; ++j)
+                meaningsData.append(QJsonObject{{"text", word(i + j)}});
+
+            QJsonArray examplesData;
+            for (int j = 0; j < examples; ++j)
+                examplesData.append(QJsonObject{{"text", paragraph(40)}, {"tr", QJsonArray{QJsonObject{{"text", paragraph(40)}}}}});
+
+            QJsonObject translation{{"text", word(i)}, {"gen", QJsonObject{{"text", "f"}}}, {"mean", meaningsData}};
+            if (!examplesData.isEmpty())
+                translation.insert(QStringLiteral("ex"), examplesData);
+            translations.append(translation);
+        }
+        regular.append(QJsonObject{{"text", text}, {"pos", QJsonObject{{"text", s_typesOfSpeech[type]}}}, {"ts", "wɜːld"}, {"tr", translations}});
+    }
+
+    return QJsonDocument(QJsonObject{{"en-de", QJsonObject{{"regular", regular}}}}).toJson(QJsonDocument::Compact);
+}
+
+QByteArray EnginePayloads::bingTranslate(const QString &text, bool)
+{
+    const QJsonObject translation{{"text", text}, {"to", "de"}, {"transliteration", QJsonObject{{"text", text}, {"script", "Latn"}}}};
+    const QJsonObject response{{"detectedLanguage", QJsonObject{{"language", "en"}, {"score", 1.0}}}, {"translations", QJsonArray{translation}}};
+    return QJsonDocument(QJsonArray{response}).toJson(QJsonDocument::Compact);
+}
+
+QByteArray EnginePayloads::bingDictionary(const QString &text, bool full)
+{
+    const int words = full ? s_fullDictionaryWords * static_cast<int>(std::size(s_typesOfSpeech)) : 2;
+    const int meanings = full ? s_fullDictionaryMeanings : 1;
+
+    QJsonArray translations;
+    for (int i = 0; i < words; ++i) {
+        QJsonArray backTranslations;
+        for (int j = 0; j < meanings; ++j)
+            backTranslations.append(QJsonObject{{"normalizedText", word(i + j)}, {"displayText", word(i + j)}, {"numExamples", 15}, {"frequencyCount", 100}});
+        translations.append(QJsonObject{{"normalizedTarget", word(i)}, {"displayTarget", word(i)}, {"posTag", QString::fromLatin1(s_typesOfSpeech[i % std::size(s_typesOfSpeech)]).toUpper()}, {"confidence", 0.5}, {"prefixWord", ""}, {"backTranslations", backTranslations}});
+    }
+
+    return QJsonDocument(QJsonArray{QJsonObject{{"normalizedSource", text}, {"displaySource", text}, {"translations", translations}}}).toJson(QJsonDocument::Compact);
+}
+
+QByteArray EnginePayloads::lingva(const QString &text, bool full)
+{
+    QJsonArray extraTranslations;
+    QJsonArray definitions;
+    if (full) {
+        for (const char *typeOfSpeech : s_typesOfSpeech) {
+            QJsonArray words;
+            QJsonArray typeDefinitions;
+            for (int i = 0; i < s_fullDictionaryWords; ++i) {
+                QJsonArray meanings;
+                for (int j = 0; j < s_fullDictionaryMeanings; ++j)
+                    meanings.append(word(i + j));
+                words.append(QJsonObject{{"word", word(i)}, {"meanings", meanings}});
+            }
+            for (int i = 0; i < s_fullDictionaryExamples; ++i)
+                typeDefinitions.append(QJsonObject{{"definition", paragraph(60)}, {"example", paragraph(40)}});
+
+            extraTranslations.append(QJsonObject{{"type", typeOfSpeech}, {"list", words}});
+            definitions.append(QJsonObject{{"type", typeOfSpeech}, {"list", typeDefinitions}});
+        }
+    }
+
+    const QJsonObject info{{"pronunciation", QJsonObject{{"translation", text}}}, {"extraTranslations", extraTranslations}, {"definitions", definitions}};
+    return QJsonDocument(QJsonObject{{"translation", text}, {"info", info}}).toJson(QJsonDocument::Compact);
+}
+
+QString EnginePayloads::paragraph(int length)
+{
+    const QString sentence = QStringLiteral("The quick brown fox jumps over the lazy dog. ");
+    return sentence.repeated(length / sentence.size() + 1).left(length).trimmed();
+}
+
+QStringList EnginePayloads::sentences(const QString &text)
+{
+    QStringList result = text.split(QStringLiteral(". "));
+    for (int i = 0; i < result.size() - 1; ++i)
+        result[i] += QStringLiteral(". ");
+    return result;
+}
+
+QString EnginePayloads::word(int index)
+{
+    return QStringLiteral("word%1").arg(index);
+}
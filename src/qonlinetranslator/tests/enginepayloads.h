@@ -0,0 +1,52 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef ENGINEPAYLOADS_H
+#define ENGINEPAYLOADS_H
+
+#include <QStringList>
+
+/**
+ * @brief Generated responses of engines
+ *
+ * Payloads have the format of real responses, but their size can be chosen
+ * to measure parsing of long texts and large dictionaries.
+ */
+class EnginePayloads
+{
+public:
+    // Data blocks of Google responses by the dt parameter
+    enum GoogleBlock {
+        GoogleTranslation = 0x1, // t
+        GoogleTranslit = 0x2, // rm
+        GoogleDictionary = 0x4, // bd
+        GoogleDefinitions = 0x8, // md
+        GoogleUnparsed = 0x10, // at, ex, ld, qc, rw and ss that were requested before
+    };
+
+    using Payload = QByteArray (*)(const QString &text, bool full);
+
+    // Payloads with dictionary data if full is set
+    static QByteArray google(const QString &text, bool full);
+    static QByteArray googleBlocks(const QString &text, int blocks);
+    static QByteArray yandexDictionary(const QString &text, bool full);
+    static QByteArray bingTranslate(const QString &text, bool full);
+    static QByteArray bingDictionary(const QString &text, bool full);
+    static QByteArray lingva(const QString &text, bool full);
+
+    static QString paragraph(int length);
+    static QStringList sentences(const QString &text);
+    static QString word(int index);
+
+private:
+    static constexpr const char *s_typesOfSpeech[] = {"noun", "verb", "adjective", "adverb"};
+    static constexpr int s_fullDictionaryWords = 8;
+    static constexpr int s_fullDictionaryMeanings = 5;
+    static constexpr int s_fullDictionaryExamples = 4;
+};
+
+#endif // ENGINEPAYLOADS_H
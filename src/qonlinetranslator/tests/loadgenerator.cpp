@@ -0,0 +1,146 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "mockengineserver.h"
+#include "qonlinetranslationjob.h"
+#include "qonlinetranslator.h"
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QMetaEnum>
+#include <QTextStream>
+
+#include <algorithm>
+
+// Translates texts in several sessions at the same time and reports throughput and latency percentiles.
+// Requests are sent to the built-in mock server unless an engine URL is specified
+class LoadGenerator : public QObject
+{
+    Q_OBJECT
+
+public:
+    LoadGenerator(QOnlineTranslator::Engine engine, int sessions, int requests, QObject *parent = nullptr)
+        : QObject(parent)
+        , m_translator(new QOnlineTranslator(this))
+        , m_engine(engine)
+        , m_sessions(sessions)
+        , m_requests(requests)
+    {
+    }
+
+    QOnlineTranslator *translator() const
+    {
+        return m_translator;
+    }
+
+    void start()
+    {
+        m_latencies.reserve(m_sessions * m_requests);
+        m_clock.start();
+        for (int session = 0; session < m_sessions; ++session)
+            translate(session, 0);
+    }
+
+signals:
+    void finished();
+
+private:
+    void translate(int session, int request)
+    {
+        // Each text is unique, so identical translations do not share requests
+        const QString text = QStringLiteral("Hello world %1-%2").arg(session).arg(request);
+        const qint64 sendTime = m_clock.nsecsElapsed();
+        QOnlineTranslationJob *job = m_translator->startTranslation(text, m_engine, QOnlineTranslator::German, QOnlineTranslator::English);
+        connect(job, &QOnlineTranslationJob::finished, this, [this, job, session, request, sendTime] {
+            m_latencies.append(static_cast<double>(m_clock.nsecsElapsed() - sendTime) / 1000000);
+            if (job->error() != QOnlineTranslator::NoError)
+                ++m_errors;
+            job->deleteLater();
+
+            if (request + 1 < m_requests)
+                translate(session, request + 1);
+            else if (++m_finishedSessions == m_sessions)
+                report();
+        });
+    }
+
+    void report()
+    {
+        const double elapsed = static_cast<double>(m_clock.nsecsElapsed()) / 1000000000;
+        std::sort(m_latencies.begin(), m_latencies.end());
+        const auto percentile = [this](double fraction) {
+            return m_latencies.at(qMin(m_latencies.size() - 1, static_cast<int>(fraction * m_latencies.size())));
+        };
+
+        QTextStream out(stdout);
+        out << "Engine: " << QMetaEnum::fromType<QOnlineTranslator::Engine>().valueToKey(m_engine) << '\n'
+            << "Sessions: " << m_sessions << '\n'
+            << "Requests: " << m_latencies.size() << " (" << m_errors << " failed)\n"
+            << "Elapsed: " << elapsed << " s\n"
+            << "Throughput: " << m_latencies.size() / elapsed << " translations/s\n"
+            << "Latency p50: " << percentile(0.5) << " ms\n"
+            << "Latency p95: " << percentile(0.95) << " ms\n"
+            << "Latency p99: " << percentile(0.99) << " ms\n"
+            << "Latency max: " << m_latencies.constLast() << " ms\n";
+        emit finished();
+    }
+
+    QOnlineTranslator *m_translator;
+    QOnlineTranslator::Engine m_engine;
+    int m_sessions;
+    int m_requests;
+    int m_finishedSessions = 0;
+    int m_errors = 0;
+    QElapsedTimer m_clock;
+    QVector<double> m_latencies;
+};
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Load generator for QOnlineTranslator"));
+    parser.addHelpOption();
+    parser.addOptions({
+        {{QStringLiteral("e"), QStringLiteral("engine")}, QStringLiteral("Engine: Google, Yandex, Bing, LibreTranslate or Lingva."), QStringLiteral("engine"), QStringLiteral("Google")},
+        {{QStringLiteral("s"), QStringLiteral("sessions")}, QStringLiteral("Number of concurrent sessions."), QStringLiteral("count"), QStringLiteral("10")},
+        {{QStringLiteral("n"), QStringLiteral("requests")}, QStringLiteral("Number of translations in each session."), QStringLiteral("count"), QStringLiteral("100")},
+        {{QStringLiteral("c"), QStringLiteral("concurrency")}, QStringLiteral("Concurrent requests to the engine, 0 to keep the default."), QStringLiteral("count"), QStringLiteral("0")},
+        {{QStringLiteral("u"), QStringLiteral("url")}, QStringLiteral("Engine URL instead of the built-in mock server."), QStringLiteral("url")},
+        {{QStringLiteral("l"), QStringLiteral("latency")}, QStringLiteral("Latency of the mock server."), QStringLiteral("msec"), QStringLiteral("0")},
+        {{QStringLiteral("j"), QStringLiteral("jitter")}, QStringLiteral("Maximum random addition to the latency of the mock server."), QStringLiteral("msec"), QStringLiteral("0")},
+        {QStringLiteral("error-rate"), QStringLiteral("Part of mock server responses that fail with the error status."), QStringLiteral("rate"), QStringLiteral("0")},
+        {QStringLiteral("error-status"), QStringLiteral("HTTP status of failed mock server responses."), QStringLiteral("status"), QStringLiteral("503")},
+    });
+    parser.process(app);
+
+    bool engineValid = false;
+    const auto engine = static_cast<QOnlineTranslator::Engine>(QMetaEnum::fromType<QOnlineTranslator::Engine>().keyToValue(parser.value(QStringLiteral("engine")).toLatin1().constData(), &engineValid));
+    if (!engineValid) {
+        QTextStream(stderr) << "Unknown engine: " << parser.value(QStringLiteral("engine")) << '\n';
+        return 1;
+    }
+
+    LoadGenerator generator(engine, qMax(1, parser.value(QStringLiteral("sessions")).toInt()), qMax(1, parser.value(QStringLiteral("requests")).toInt()));
+    if (const int concurrency = parser.value(QStringLiteral("concurrency")).toInt(); concurrency > 0)
+        generator.translator()->setEngineConcurrency(engine, concurrency);
+
+    MockEngineServer server;
+    server.setLatency(parser.value(QStringLiteral("latency")).toInt());
+    server.setJitter(parser.value(QStringLiteral("jitter")).toInt());
+    server.setErrorRate(parser.value(QStringLiteral("error-rate")).toDouble());
+    server.setErrorStatus(parser.value(QStringLiteral("error-status")).toInt());
+    generator.translator()->setEngineUrl(engine, parser.isSet(QStringLiteral("url")) ? parser.value(QStringLiteral("url")) : server.url());
+
+    QObject::connect(&generator, &LoadGenerator::finished, &app, &QCoreApplication::quit);
+    generator.start();
+    return QCoreApplication::exec();
+}
+
+#include "loadgenerator.moc"
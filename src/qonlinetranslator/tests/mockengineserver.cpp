@@ -0,0 +1,261 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "mockengineserver.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QPointer>
+#include <QTcpSocket>
+#include <QTimer>
+
+#include <algorithm>
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+#include <QRandomGenerator>
+#endif
+
+MockEngineServer::MockEngineServer(QObject *parent)
+    : QTcpServer(parent)
+{
+    Q_INIT_RESOURCE(responses);
+    setCannedResponses();
+    listen(QHostAddress::LocalHost);
+}
+
+QString MockEngineServer::url() const
+{
+    return QStringLiteral("http://127.0.0.1:%1").arg(serverPort());
+}
+
+void MockEngineServer::setResponse(const QByteArray &pathPrefix, const Response &response)
+{
+    m_responses.insert(pathPrefix, response);
+}
+
+void MockEngineServer::queueResponse(const QByteArray &pathPrefix, const Response &response)
+{
+    m_queuedResponses[pathPrefix].append(response);
+}
+
+// Recorded responses of real engines for "Hello world" and "world" from English to German
+void MockEngineServer::setCannedResponses()
+{
+    m_queuedResponses.clear();
+
+    // Google
+    setResponse("/translate_a/single", recordedResponse(QStringLiteral("google-translate.json")));
+
+    // Yandex
+    setResponse("/api/v1/tr.json/translate", recordedResponse(QStringLiteral("yandex-translate.json")));
+    setResponse("/translit/translit", recordedResponse(QStringLiteral("yandex-translit.json")));
+    setResponse("/dicservice.json/lookupMultiple", recordedResponse(QStringLiteral("yandex-dictionary.json")));
+
+    // Bing
+    setResponse("/translator", recordedResponse(QStringLiteral("bing-translator.html"), "text/html"));
+    setResponse("/ttranslatev3", recordedResponse(QStringLiteral("bing-translate.json")));
+    setResponse("/tlookupv3", recordedResponse(QStringLiteral("bing-dictionary.json")));
+
+    // LibreTranslate
+    setResponse("/detect", recordedResponse(QStringLiteral("libretranslate-detect.json")));
+    setResponse("/translate", recordedResponse(QStringLiteral("libretranslate-translate.json")));
+
+    // Lingva
+    setResponse("/api/v1/", recordedResponse(QStringLiteral("lingva-translate.json")));
+}
+
+int MockEngineServer::latency() const
+{
+    return m_latency;
+}
+
+void MockEngineServer::setLatency(int msec)
+{
+    m_latency = msec;
+}
+
+int MockEngineServer::jitter() const
+{
+    return m_jitter;
+}
+
+void MockEngineServer::setJitter(int msec)
+{
+    m_jitter = msec;
+}
+
+double MockEngineServer::errorRate() const
+{
+    return m_errorRate;
+}
+
+void MockEngineServer::setErrorRate(double rate)
+{
+    m_errorRate = rate;
+}
+
+int MockEngineServer::errorStatus() const
+{
+    return m_errorStatus;
+}
+
+void MockEngineServer::setErrorStatus(int status)
+{
+    m_errorStatus = status;
+}
+
+int MockEngineServer::maxRequestSize() const
+{
+    return m_maxRequestSize;
+}
+
+void MockEngineServer::setMaxRequestSize(int bytes)
+{
+    m_maxRequestSize = bytes;
+}
+
+int MockEngineServer::requestCount() const
+{
+    return m_requestedPaths.size();
+}
+
+int MockEngineServer::requestCount(const QByteArray &pathPrefix) const
+{
+    return static_cast<int>(std::count_if(m_requestedPaths.cbegin(), m_requestedPaths.cend(), [&pathPrefix](const QByteArray &path) {
+        return path.startsWith(pathPrefix);
+    }));
+}
+
+const QByteArrayList &MockEngineServer::requestedPaths() const
+{
+    return m_requestedPaths;
+}
+
+void MockEngineServer::resetRequests()
+{
+    m_requestedPaths.clear();
+}
+
+void MockEngineServer::incomingConnection(qintptr socketDescriptor)
+{
+    auto *socket = new QTcpSocket(this);
+    socket->setSocketDescriptor(socketDescriptor);
+    connect(socket, &QTcpSocket::readyRead, this, [this, socket] {
+        readRequest(socket);
+    });
+    connect(socket, &QTcpSocket::disconnected, this, [this, socket] {
+        m_buffers.remove(socket);
+        socket->deleteLater();
+    });
+}
+
+void MockEngineServer::readRequest(QTcpSocket *socket)
+{
+    QByteArray &buffer = m_buffers[socket];
+    buffer += socket->readAll();
+
+    // Wait for the headers and the body
+    const int headersEnd = buffer.indexOf("\r\n\r\n");
+    if (headersEnd == -1)
+        return;
+
+    int contentLength = 0;
+    const QList<QByteArray> lines = buffer.left(headersEnd).split('\n');
+    for (const QByteArray &line : lines) {
+        if (line.toLower().startsWith("content-length:"))
+            contentLength = line.mid(line.indexOf(':') + 1).trimmed().toInt();
+    }
+    if (buffer.size() < headersEnd + 4 + contentLength)
+        return;
+
+    // Request line has the following format: METHOD target HTTP/version
+    const QByteArray target = lines.first().split(' ').value(1);
+    m_requestedPaths.append(target);
+    m_buffers.remove(socket);
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 10, 0)
+    const bool failed = QRandomGenerator::global()->generateDouble() < m_errorRate;
+    const int delay = m_latency + (m_jitter > 0 ? QRandomGenerator::global()->bounded(m_jitter + 1) : 0);
+#else
+    const bool failed = static_cast<double>(qrand()) / RAND_MAX < m_errorRate;
+    const int delay = m_latency + (m_jitter > 0 ? qrand() % (m_jitter + 1) : 0);
+#endif
+
+    Response reply;
+    if (m_maxRequestSize != 0 && target.size() + contentLength > m_maxRequestSize)
+        reply = {413, "text/plain", {}};
+    else if (failed)
+        reply = {m_errorStatus, "text/plain", {}};
+    else
+        reply = response(target.left(target.indexOf('?')));
+    QTimer::singleShot(delay + reply.delay, this, [socket = QPointer<QTcpSocket>(socket), reply] {
+        if (socket != nullptr)
+            sendResponse(socket, reply);
+    });
+}
+
+MockEngineServer::Response MockEngineServer::recordedResponse(const QString &fileName, const QByteArray &contentType)
+{
+    QFile file(QStringLiteral(":/responses/") + fileName);
+    if (!file.open(QFile::ReadOnly)) {
+        qWarning() << "Unable to read recorded response" << file.fileName();
+        return {404, "text/plain", {}};
+    }
+
+    return {200, contentType, file.readAll()};
+}
+
+MockEngineServer::Response MockEngineServer::response(const QByteArray &path)
+{
+    for (auto it = m_queuedResponses.begin(); it != m_queuedResponses.end(); ++it) {
+        if (path.startsWith(it.key()) && !it.value().isEmpty())
+            return it.value().takeFirst();
+    }
+
+    QByteArray matchedPrefix;
+    for (auto it = m_responses.cbegin(); it != m_responses.cend(); ++it) {
+        if (path.startsWith(it.key()) && it.key().size() > matchedPrefix.size())
+            matchedPrefix = it.key();
+    }
+
+    if (matchedPrefix.isEmpty())
+        return {404, "text/plain", {}};
+
+    return m_responses.value(matchedPrefix);
+}
+
+void MockEngineServer::sendResponse(QTcpSocket *socket, const Response &response)
+{
+    socket->write("HTTP/1.1 " + QByteArray::number(response.status) + ' ' + statusText(response.status) + "\r\n"
+                  + "Content-Type: " + response.contentType + "\r\n"
+                  + "Content-Length: " + QByteArray::number(response.body.size()) + "\r\n"
+                  + "Connection: close\r\n\r\n"
+                  + response.body);
+    socket->disconnectFromHost();
+}
+
+QByteArray MockEngineServer::statusText(int status)
+{
+    switch (status) {
+    case 200:
+        return "OK";
+    case 401:
+        return "Unauthorized";
+    case 403:
+        return "Forbidden";
+    case 404:
+        return "Not Found";
+    case 413:
+        return "Payload Too Large";
+    case 429:
+        return "Too Many Requests";
+    case 503:
+        return "Service Unavailable";
+    default:
+        return "Error";
+    }
+}
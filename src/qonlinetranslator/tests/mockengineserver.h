@@ -0,0 +1,93 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef MOCKENGINESERVER_H
+#define MOCKENGINESERVER_H
+
+#include <QMap>
+#include <QTcpServer>
+
+class QTcpSocket;
+
+/**
+ * @brief Local HTTP server that imitates translation engines
+ *
+ * Serves recorded responses of Google, Yandex, Bing, LibreTranslate and Lingva by the request path,
+ * so all engines can be pointed to url() with QOnlineTranslator::setEngineUrl().
+ * Responses can be delayed by a latency with random jitter, and a part of requests can fail with an error status.
+ * Requests larger than the maximum size are rejected with 413 Payload Too Large.
+ * Each connection is closed after the response.
+ */
+class MockEngineServer : public QTcpServer
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(MockEngineServer)
+
+public:
+    struct Response {
+        int status = 200;
+        QByteArray contentType = "application/json";
+        QByteArray body;
+        int delay = 0; // Added to the server latency
+    };
+
+    explicit MockEngineServer(QObject *parent = nullptr);
+
+    QString url() const;
+
+    // Responses are chosen by the longest matching path prefix
+    void setResponse(const QByteArray &pathPrefix, const Response &response);
+    void setCannedResponses();
+
+    // Reads a response from tests/data/responses
+    static Response recordedResponse(const QString &fileName, const QByteArray &contentType = "application/json");
+
+    // Served once for the next request with the prefix before the regular response
+    void queueResponse(const QByteArray &pathPrefix, const Response &response);
+
+    int latency() const;
+    void setLatency(int msec);
+
+    int jitter() const;
+    void setJitter(int msec);
+
+    double errorRate() const;
+    void setErrorRate(double rate);
+
+    int errorStatus() const;
+    void setErrorStatus(int status);
+
+    // Size of the request target and body, 0 if unlimited
+    int maxRequestSize() const;
+    void setMaxRequestSize(int bytes);
+
+    int requestCount() const;
+    int requestCount(const QByteArray &pathPrefix) const;
+    const QByteArrayList &requestedPaths() const;
+    void resetRequests();
+
+protected:
+    void incomingConnection(qintptr socketDescriptor) override;
+
+private:
+    void readRequest(QTcpSocket *socket);
+    Response response(const QByteArray &path);
+    static void sendResponse(QTcpSocket *socket, const Response &response);
+    static QByteArray statusText(int status);
+
+    QMap<QByteArray, Response> m_responses;
+    QMap<QByteArray, QList<Response>> m_queuedResponses;
+    QMap<QTcpSocket *, QByteArray> m_buffers;
+    QByteArrayList m_requestedPaths;
+    int m_latency = 0;
+    int m_jitter = 0;
+    double m_errorRate = 0;
+    int m_errorStatus = 503;
+    int m_maxRequestSize = 0;
+};
+
+#endif // MOCKENGINESERVER_H
@@ -0,0 +1,168 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "enginepayloads.h"
+#include "qonlinetranslationjob.h"
+#include "qonlinetranslator.h"
+#include "recordedreply.h"
+
+#include <QEventLoop>
+#include <QFinalState>
+#include <QStateMachine>
+#include <QTest>
+
+// Compares dispatching of engine requests by the step pipeline and by the state machine that was used before.
+// Allocations are reported separately by the Allocations target of the benchmark
+class QOnlineDispatchBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+
+    void dispatchSteps();
+    void dispatchStateMachine();
+
+private:
+    void setupDispatch(QOnlineTranslationJob &job);
+
+    static QStateMachine *buildYandexStateMachine(QOnlineTranslationJob &job);
+    static void buildSplitNetworkRequest(QOnlineTranslationJob &job, QState *parent, QOnlineTranslationJob::RequestMethod requestMethod, QOnlineTranslationJob::ParseMethod parseMethod, const QString QOnlineTranslationJob::*text);
+    static void buildNetworkRequestState(QOnlineTranslationJob &job, QState *parent, QOnlineTranslationJob::RequestMethod requestMethod, QOnlineTranslationJob::ParseMethod parseMethod, const QString QOnlineTranslationJob::*text);
+
+    QOnlineTranslator m_translator;
+    RecordedNetworkAccessManager m_networkManager;
+};
+
+void QOnlineDispatchBenchmark::initTestCase()
+{
+    // Yandex has the longest pipeline: translation, transliterations and dictionary
+    m_networkManager.setResponse(QStringLiteral("/api/v1/tr.json/translate"), R"({"code":200,"lang":"en-de","text":["Welt"]})");
+    m_networkManager.setResponse(QStringLiteral("/translit/translit"), R"("velt")");
+    m_networkManager.setResponse(QStringLiteral("/dicservice.json/lookupMultiple"), EnginePayloads::yandexDictionary(EnginePayloads::word(0), true));
+}
+
+void QOnlineDispatchBenchmark::dispatchSteps()
+{
+    QOnlineTranslationJob job(&m_translator);
+    setupDispatch(job);
+
+    QEventLoop loop;
+    connect(&job, &QOnlineTranslationJob::finished, &loop, &QEventLoop::quit);
+    const auto translate = [&job, &loop] {
+        job.resetData();
+        job.buildYandexPipeline();
+        job.startSteps();
+        loop.exec();
+    };
+
+    QBENCHMARK {
+        translate();
+    }
+    QVERIFY2(job.m_error == QOnlineTranslator::NoError, qPrintable(job.m_errorString));
+    QCOMPARE(job.m_translation, QStringLiteral("Welt"));
+    QVERIFY(!job.m_translationOptions.isEmpty());
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+}
+
+void QOnlineDispatchBenchmark::dispatchStateMachine()
+{
+    QOnlineTranslationJob job(&m_translator);
+    setupDispatch(job);
+
+    // The machine was built for every translation and its states were deleted by resetData()
+    const auto translate = [&job] {
+        job.resetData();
+        QStateMachine *stateMachine = buildYandexStateMachine(job);
+        QEventLoop loop;
+        connect(stateMachine, &QStateMachine::finished, &loop, &QEventLoop::quit);
+        stateMachine->start();
+        loop.exec();
+        delete stateMachine;
+    };
+
+    QBENCHMARK {
+        translate();
+    }
+    QVERIFY2(job.m_error == QOnlineTranslator::NoError, qPrintable(job.m_errorString));
+    QCOMPARE(job.m_translation, QStringLiteral("Welt"));
+    QVERIFY(!job.m_translationOptions.isEmpty());
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+}
+
+void QOnlineDispatchBenchmark::setupDispatch(QOnlineTranslationJob &job)
+{
+    job.m_networkManager = &m_networkManager;
+    job.m_scheduler = nullptr;
+    job.m_engine = QOnlineTranslator::Yandex;
+    job.m_source = EnginePayloads::word(0);
+    job.m_sourceLang = QOnlineTranslator::English;
+    job.m_translationLang = QOnlineTranslator::German;
+    job.m_uiLang = QOnlineTranslator::English;
+
+    // The state machine had no deadlines
+    job.m_engineResponseTimeouts.insert(QOnlineTranslator::Yandex, 0);
+    job.m_engineTimeouts.insert(QOnlineTranslator::Yandex, 0);
+}
+
+// Same states as the removed Yandex state machine, one compound state for each request
+QStateMachine *QOnlineDispatchBenchmark::buildYandexStateMachine(QOnlineTranslationJob &job)
+{
+    auto *stateMachine = new QStateMachine(&job);
+    auto *translationState = new QState(stateMachine);
+    auto *sourceTranslitState = new QState(stateMachine);
+    auto *translationTranslitState = new QState(stateMachine);
+    auto *dictionaryState = new QState(stateMachine);
+    auto *finalState = new QFinalState(stateMachine);
+    stateMachine->setInitialState(translationState);
+
+    translationState->addTransition(translationState, &QState::finished, sourceTranslitState);
+    sourceTranslitState->addTransition(sourceTranslitState, &QState::finished, translationTranslitState);
+    translationTranslitState->addTransition(translationTranslitState, &QState::finished, dictionaryState);
+    dictionaryState->addTransition(dictionaryState, &QState::finished, finalState);
+
+    buildSplitNetworkRequest(job, translationState, &QOnlineTranslationJob::requestYandexTranslate, &QOnlineTranslationJob::parseYandexTranslate, &QOnlineTranslationJob::m_source);
+    buildSplitNetworkRequest(job, sourceTranslitState, &QOnlineTranslationJob::requestYandexSourceTranslit, &QOnlineTranslationJob::parseYandexSourceTranslit, &QOnlineTranslationJob::m_source);
+    buildSplitNetworkRequest(job, translationTranslitState, &QOnlineTranslationJob::requestYandexTranslationTranslit, &QOnlineTranslationJob::parseYandexTranslationTranslit, &QOnlineTranslationJob::m_translation);
+    buildNetworkRequestState(job, dictionaryState, &QOnlineTranslationJob::requestYandexDictionary, &QOnlineTranslationJob::parseYandexDictionary, &QOnlineTranslationJob::m_source);
+    return stateMachine;
+}
+
+// The source is a word, so the text has a single part
+void QOnlineDispatchBenchmark::buildSplitNetworkRequest(QOnlineTranslationJob &job, QState *parent, QOnlineTranslationJob::RequestMethod requestMethod, QOnlineTranslationJob::ParseMethod parseMethod, const QString QOnlineTranslationJob::*text)
+{
+    auto *translationState = new QState(parent);
+    auto *nextTranslationState = new QState(parent);
+    parent->setInitialState(translationState);
+
+    buildNetworkRequestState(job, translationState, requestMethod, parseMethod, text);
+    translationState->addTransition(translationState, &QState::finished, nextTranslationState);
+    nextTranslationState->addTransition(new QFinalState(parent));
+}
+
+void QOnlineDispatchBenchmark::buildNetworkRequestState(QOnlineTranslationJob &job, QState *parent, QOnlineTranslationJob::RequestMethod requestMethod, QOnlineTranslationJob::ParseMethod parseMethod, const QString QOnlineTranslationJob::*text)
+{
+    auto *requestingState = new QState(parent);
+    auto *parsingState = new QState(parent);
+    parent->setInitialState(requestingState);
+
+    requestingState->addTransition(job.m_networkManager, &QNetworkAccessManager::finished, parsingState);
+    parsingState->addTransition(new QFinalState(parent));
+
+    connect(requestingState, &QState::entered, &job, [&job, requestingState, requestMethod, text] {
+        job.m_currentReply = (job.*requestMethod)(job.*text);
+
+        // Skip parsing if there is nothing to request
+        if (job.m_currentReply == nullptr)
+            requestingState->addTransition(new QFinalState(requestingState->parentState()));
+    });
+    connect(parsingState, &QState::entered, &job, parseMethod);
+}
+
+QTEST_GUILESS_MAIN(QOnlineDispatchBenchmark)
+
+#include "qonlinedispatchbenchmark.moc"
@@ -0,0 +1,73 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "enginepayloads.h"
+#include "qonlinetranslationjob.h"
+#include "qonlinetranslator.h"
+#include "recordedreply.h"
+
+#include <QTest>
+
+// Parses Google responses with the data blocks that are requested now and with all blocks that were requested before.
+// Allocations are reported separately by the Allocations target of the benchmark
+class QOnlineGoogleBlocksBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseDataBlocks_data();
+    void parseDataBlocks();
+
+private:
+    QOnlineTranslator m_translator;
+};
+
+void QOnlineGoogleBlocksBenchmark::parseDataBlocks_data()
+{
+    QTest::addColumn<QString>("source");
+    QTest::addColumn<QByteArray>("payload");
+
+    // Dictionary blocks are requested only for text shorter than the limit and have data only for words
+    const int requestedBlocks = EnginePayloads::GoogleTranslation | EnginePayloads::GoogleTranslit | EnginePayloads::GoogleDictionary | EnginePayloads::GoogleDefinitions;
+    const QString source = EnginePayloads::word(0);
+    QTest::newRow("word, translation only") << source << EnginePayloads::googleBlocks(source, EnginePayloads::GoogleTranslation);
+    QTest::newRow("word, requested blocks") << source << EnginePayloads::googleBlocks(source, requestedBlocks);
+    QTest::newRow("word, all blocks") << source << EnginePayloads::googleBlocks(source, requestedBlocks | EnginePayloads::GoogleUnparsed);
+    for (const int length : {1000, 5000}) {
+        const QString text = EnginePayloads::paragraph(length);
+        QTest::addRow("paragraph %d, translation only", length) << text << EnginePayloads::googleBlocks(text, EnginePayloads::GoogleTranslation);
+        QTest::addRow("paragraph %d, requested blocks", length) << text << EnginePayloads::googleBlocks(text, requestedBlocks);
+        QTest::addRow("paragraph %d, all blocks", length) << text << EnginePayloads::googleBlocks(text, requestedBlocks | EnginePayloads::GoogleUnparsed);
+    }
+}
+
+void QOnlineGoogleBlocksBenchmark::parseDataBlocks()
+{
+    QFETCH(QString, source);
+    QFETCH(QByteArray, payload);
+
+    qInfo("Payload: %d bytes", payload.size());
+
+    QOnlineTranslationJob job(&m_translator);
+    job.m_source = source;
+    job.m_sourceLang = QOnlineTranslator::English;
+    job.m_translationLang = QOnlineTranslator::German;
+    job.m_uiLang = QOnlineTranslator::English;
+
+    QBENCHMARK {
+        job.resetData();
+        job.m_currentReply = new RecordedReply(payload, &job);
+        job.parseGoogleTranslate();
+    }
+    QVERIFY2(job.m_error == QOnlineTranslator::NoError, qPrintable(job.m_errorString));
+    QVERIFY(!job.m_translation.isEmpty());
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+}
+
+QTEST_GUILESS_MAIN(QOnlineGoogleBlocksBenchmark)
+
+#include "qonlinegoogleblocksbenchmark.moc"
@@ -0,0 +1,139 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "enginepayloads.h"
+#include "qonlinetranslationjob.h"
+#include "qonlinetranslator.h"
+#include "recordedreply.h"
+
+#include <QTest>
+
+// Feeds responses of engines to parsers, payloads are generated in the format of real responses.
+// Allocations are reported separately by the Allocations target of the benchmark
+class QOnlineTranslationJobBenchmark : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void parseGoogleTranslate_data();
+    void parseGoogleTranslate();
+    void parseYandexDictionary_data();
+    void parseYandexDictionary();
+    void parseBingTranslate_data();
+    void parseBingTranslate();
+    void parseBingDictionary_data();
+    void parseBingDictionary();
+    void parseLingvaTranslate_data();
+    void parseLingvaTranslate();
+
+private:
+    void benchmarkParser(void (QOnlineTranslationJob::*parseMethod)());
+
+    static void addTextRows(EnginePayloads::Payload payload);
+    static void addDictionaryRows(EnginePayloads::Payload payload);
+
+    QOnlineTranslator m_translator;
+};
+
+void QOnlineTranslationJobBenchmark::parseGoogleTranslate_data()
+{
+    addTextRows(EnginePayloads::google);
+}
+
+void QOnlineTranslationJobBenchmark::parseGoogleTranslate()
+{
+    benchmarkParser(&QOnlineTranslationJob::parseGoogleTranslate);
+}
+
+void QOnlineTranslationJobBenchmark::parseYandexDictionary_data()
+{
+    addDictionaryRows(EnginePayloads::yandexDictionary);
+}
+
+void QOnlineTranslationJobBenchmark::parseYandexDictionary()
+{
+    benchmarkParser(&QOnlineTranslationJob::parseYandexDictionary);
+}
+
+void QOnlineTranslationJobBenchmark::parseBingTranslate_data()
+{
+    addTextRows(EnginePayloads::bingTranslate);
+}
+
+void QOnlineTranslationJobBenchmark::parseBingTranslate()
+{
+    benchmarkParser(&QOnlineTranslationJob::parseBingTranslate);
+}
+
+void QOnlineTranslationJobBenchmark::parseBingDictionary_data()
+{
+    addDictionaryRows(EnginePayloads::bingDictionary);
+}
+
+void QOnlineTranslationJobBenchmark::parseBingDictionary()
+{
+    benchmarkParser(&QOnlineTranslationJob::parseBingDictionary);
+}
+
+void QOnlineTranslationJobBenchmark::parseLingvaTranslate_data()
+{
+    addTextRows(EnginePayloads::lingva);
+}
+
+void QOnlineTranslationJobBenchmark::parseLingvaTranslate()
+{
+    benchmarkParser(&QOnlineTranslationJob::parseLingvaTranslate);
+}
+
+void QOnlineTranslationJobBenchmark::benchmarkParser(void (QOnlineTranslationJob::*parseMethod)())
+{
+    QFETCH(QString, source);
+    QFETCH(QByteArray, payload);
+
+    QOnlineTranslationJob job(&m_translator);
+    job.m_source = source;
+    job.m_sourceLang = QOnlineTranslator::English;
+    job.m_translationLang = QOnlineTranslator::German;
+    job.m_uiLang = QOnlineTranslator::English;
+
+    QBENCHMARK {
+        job.resetData();
+        job.m_currentReply = new RecordedReply(payload, &job);
+        (job.*parseMethod)();
+    }
+    QVERIFY2(job.m_error == QOnlineTranslator::NoError, qPrintable(job.m_errorString));
+    QVERIFY(!job.m_translation.isEmpty() || !job.m_translationOptions.isEmpty());
+    QCoreApplication::sendPostedEvents(nullptr, QEvent::DeferredDelete);
+}
+
+void QOnlineTranslationJobBenchmark::addTextRows(EnginePayloads::Payload payload)
+{
+    QTest::addColumn<QString>("source");
+    QTest::addColumn<QByteArray>("payload");
+
+    const QString source = EnginePayloads::word(0);
+    QTest::newRow("word") << source << payload(source, false);
+    QTest::newRow("word with dictionary") << source << payload(source, true);
+    for (const int length : {1000, 5000}) {
+        const QString text = EnginePayloads::paragraph(length);
+        QTest::addRow("paragraph %d", length) << text << payload(text, false);
+    }
+}
+
+void QOnlineTranslationJobBenchmark::addDictionaryRows(EnginePayloads::Payload payload)
+{
+    QTest::addColumn<QString>("source");
+    QTest::addColumn<QByteArray>("payload");
+
+    const QString source = EnginePayloads::word(0);
+    QTest::newRow("word") << source << payload(source, false);
+    QTest::newRow("word with full dictionary") << source << payload(source, true);
+}
+
+QTEST_GUILESS_MAIN(QOnlineTranslationJobBenchmark)
+
+#include "qonlinetranslationjobbenchmark.moc"
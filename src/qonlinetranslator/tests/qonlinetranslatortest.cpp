@@ -0,0 +1,652 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "mockengineserver.h"
+#include "qlanguageidentifier.h"
+#include "qonlinebatchtranslationjob.h"
+#include "qonlinerequestscheduler.h"
+#include "qonlinetranslationcache.h"
+#include "qonlinetranslationjob.h"
+#include "qonlinetranslator.h"
+#include "qtextsegmenter.h"
+
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QStandardPaths>
+#include <QTest>
+
+#include <algorithm>
+
+class QOnlineTranslatorTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void init();
+
+    void translate_data();
+    void translate();
+    void detectLanguage_data();
+    void detectLanguage();
+    void dictionary_data();
+    void dictionary();
+
+    void serviceError();
+    void timeout();
+    void rejectedChunk();
+    void bingCredentialsRenewal();
+    void cache();
+    void abortCached();
+    void incrementalTranslation();
+    void identicalTranslations();
+    void schedulerRequestRate();
+    void schedulerBackoff();
+    void orderedParts();
+    void bingCredentialsExtraction();
+    void hedging_data();
+    void hedging();
+    void batchTranslation();
+    void batchLineCountFallback();
+
+    void textSegmenter_data();
+    void textSegmenter();
+    void languageTables_data();
+    void languageTables();
+    void languageIdentifier_data();
+    void languageIdentifier();
+
+private:
+    void setupTranslator(QOnlineTranslator &translator) const;
+
+    static constexpr int s_timeout = 5000;
+
+    MockEngineServer m_server;
+};
+
+void QOnlineTranslatorTest::initTestCase()
+{
+    // Do not touch Bing credentials and cache of the user
+    QStandardPaths::setTestModeEnabled(true);
+    QVERIFY(m_server.isListening());
+}
+
+void QOnlineTranslatorTest::init()
+{
+    m_server.setCannedResponses();
+    m_server.setLatency(0);
+    m_server.setJitter(0);
+    m_server.setErrorRate(0);
+    m_server.setMaxRequestSize(0);
+    m_server.resetRequests();
+}
+
+void QOnlineTranslatorTest::translate_data()
+{
+    QTest::addColumn<QOnlineTranslator::Engine>("engine");
+
+    QTest::newRow("Google") << QOnlineTranslator::Google;
+    QTest::newRow("Yandex") << QOnlineTranslator::Yandex;
+    QTest::newRow("Bing") << QOnlineTranslator::Bing;
+    QTest::newRow("LibreTranslate") << QOnlineTranslator::LibreTranslate;
+    QTest::newRow("Lingva") << QOnlineTranslator::Lingva;
+}
+
+void QOnlineTranslatorTest::translate()
+{
+    QFETCH(QOnlineTranslator::Engine, engine);
+
+    QOnlineTranslator translator;
+    setupTranslator(translator);
+    QSignalSpy finishedSpy(&translator, &QOnlineTranslator::finished);
+    translator.translate(QStringLiteral("Hello world"), engine, QOnlineTranslator::German, QOnlineTranslator::English);
+
+    QVERIFY(finishedSpy.wait(s_timeout));
+    QVERIFY2(translator.error() == QOnlineTranslator::NoError, qPrintable(translator.errorString()));
+    QCOMPARE(translator.translation(), QStringLiteral("Hallo Welt"));
+    QCOMPARE(translator.sourceLanguage(), QOnlineTranslator::English);
+}
+
+void QOnlineTranslatorTest::detectLanguage_data()
+{
+    QTest::addColumn<QOnlineTranslator::Engine>("engine");
+
+    QTest::newRow("Google") << QOnlineTranslator::Google;
+    QTest::newRow("Yandex") << QOnlineTranslator::Yandex;
+    QTest::newRow("Bing") << QOnlineTranslator::Bing;
+    QTest::newRow("LibreTranslate") << QOnlineTranslator::LibreTranslate;
+}
+
+void QOnlineTranslatorTest::detectLanguage()
+{
+    QFETCH(QOnlineTranslator::Engine, engine);
+
+    QOnlineTranslator translator;
+    setupTranslator(translator);
+    // Use the engine even if the text can be identified offline
+    translator.setOfflineDetectionThreshold(2);
+    QSignalSpy finishedSpy(&translator, &QOnlineTranslator::finished);
+    translator.detectLanguage(QStringLiteral("Hello world"), engine);
+
+    QVERIFY(finishedSpy.wait(s_timeout));
+    QVERIFY2(translator.error() == QOnlineTranslator::NoError, qPrintable(translator.errorString()));
+    QCOMPARE(translator.sourceLanguage(), QOnlineTranslator::English);
+}
+
+void QOnlineTranslatorTest::dictionary_data()
+{
+    QTest::addColumn<QOnlineTranslator::Engine>("engine");
+
+    QTest::newRow("Yandex") << QOnlineTranslator::Yandex;
+    QTest::newRow("Bing") << QOnlineTranslator::Bing;
+    QTest::newRow("Lingva") << QOnlineTranslator::Lingva;
+}
+
+void QOnlineTranslatorTest::dictionary()
+{
+    QFETCH(QOnlineTranslator::Engine, engine);
+
+    QOnlineTranslator translator;
+    setupTranslator(translator);
+    QSignalSpy finishedSpy(&translator, &QOnlineTranslator::finished);
+    translator.translate(QStringLiteral("world"), engine, QOnlineTranslator::German, QOnlineTranslator::English);
+
+    QVERIFY(finishedSpy.wait(s_timeout));
+    QVERIFY2(translator.error() == QOnlineTranslator::NoError, qPrintable(translator.errorString()));
+    QVERIFY(translator.translationOptions().contains(QStringLiteral("noun")));
+}
+
+void QOnlineTranslatorTest::serviceError()
+{
+    m_server.setErrorRate(1);
+    m_server.setErrorStatus(503);
+
+    QOnlineTranslator translator;
+    setupTranslator(translator);
+    translator.setMaxRetries(0);
+    QSignalSpy finishedSpy(&translator, &QOnlineTranslator::finished);
+    translator.translate(QStringLiteral("Hello world"), QOnlineTranslator::Google, QOnlineTranslator::German, QOnlineTranslator::English);
+
+    QVERIFY(finishedSpy.wait(s_timeout));
+    QCOMPARE(translator.error(), QOnlineTranslator::ServiceError);
+    QCOMPARE(m_server.requestCount(), 1);
+}
+
+void QOnlineTranslatorTest::timeout()
+{
+    m_server.setLatency(s_timeout / 2);
+
+    QOnlineTranslator translator;
+    setupTranslator(translator);
+    translator.setMaxRetries(0);
+    translator.setEngineTimeout(QOnlineTranslator::Google, 100);
+    QSignalSpy finishedSpy(&translator, &QOnlineTranslator::finished);
+    translator.translate(QStringLiteral("Hello world"), QOnlineTranslator::Google, QOnlineTranslator::German, QOnlineTranslator::English);
+
+    QVERIFY(finishedSpy.wait(s_timeout / 4));
+    QCOMPARE(translator.error(), QOnlineTranslator::NetworkError);
+}
+
+void QOnlineTranslatorTest::rejectedChunk()
+{
+    m_server.setMaxRequestSize(1000);
+
+    QOnlineTranslator translator;
+    setupTranslator(translator);
+    translator.setChunkSizeTuningEnabled(true);
+    QSignalSpy finishedSpy(&translator, &QOnlineTranslator::finished);
+    translator.translate(QStringLiteral("Hello world. ").repeated(100), QOnlineTranslator::Google, QOnlineTranslator::German, QOnlineTranslator::English);
+
+    // The text fits into the default chunk size, but the server accepts only smaller parts
+    QVERIFY(finishedSpy.wait(s_timeout));
+    QVERIFY2(translator.error() == QOnlineTranslator::NoError, qPrintable(translator.errorString()));
+    QVERIFY(translator.translation().count(QStringLiteral("Hallo Welt")) > 1);
+}
+
+void QOnlineTranslatorTest::bingCredentialsRenewal()
+{
+    QOnlineTranslator translator;
+    setupTranslator(translator);
+    QSignalSpy finishedSpy(&translator, &QOnlineTranslator::finished);
+    translator.translate(QStringLiteral("Hello world"), QOnlineTranslator::Bing, QOnlineTranslator::German, QOnlineTranslator::English);
+    QVERIFY(finishedSpy.wait(s_timeout));
+
+    // Saved credentials expired on the server side
+    m_server.resetRequests();
+    m_server.setLatency(50);
+    m_server.queueResponse("/ttranslatev3", {200, "application/json", R"({"statusCode":401,"errorMessage":""})"});
+    QOnlineTranslationJob *firstJob = translator.startTranslation(QStringLiteral("Hello world"), QOnlineTranslator::Bing, QOnlineTranslator::German, QOnlineTranslator::English);
+    QOnlineTranslationJob *secondJob = translator.startTranslation(QStringLiteral("Hello world"), QOnlineTranslator::Bing, QOnlineTranslator::German, QOnlineTranslator::English);
+
+    QSignalSpy firstSpy(firstJob, &QOnlineTranslationJob::finished);
+    QSignalSpy secondSpy(secondJob, &QOnlineTranslationJob::finished);
+    QVERIFY(firstSpy.wait(s_timeout));
+    QVERIFY(secondSpy.count() == 1 || secondSpy.wait(s_timeout));
+
+    QVERIFY2(firstJob->error() == QOnlineTranslator::NoError, qPrintable(firstJob->errorString()));
+    QCOMPARE(firstJob->translation(), QStringLiteral("Hallo Welt"));
+    QCOMPARE(secondJob->translation(), QStringLiteral("Hallo Welt"));
+
+    // Only the rejected request is sent again, the waiting job does not send its own
+    QCOMPARE(m_server.requestCount("/translator"), 1);
+    QCOMPARE(m_server.requestCount("/ttranslatev3"), 2);
+}
+
+void QOnlineTranslatorTest::cache()
+{
+    QOnlineTranslator translator;
+    setupTranslator(translator);
+    auto *cache = new QOnlineTranslationCache(&translator);
+    cache->setMaxDiskEntries(0);
+    translator.setCache(cache);
+
+    QSignalSpy finishedSpy(&translator, &QOnlineTranslator::finished);
+    for (int i = 0; i < 2; ++i) {
+        translator.translate(QStringLiteral("Hello world"), QOnlineTranslator::Google, QOnlineTranslator::German, QOnlineTranslator::English);
+        QVERIFY(finishedSpy.wait(s_timeout));
+        QVERIFY2(translator.error() == QOnlineTranslator::NoError, qPrintable(translator.errorString()));
+        QCOMPARE(translator.translation(), QStringLiteral("Hallo Welt"));
+    }
+
+    QCOMPARE(m_server.requestCount(), 1);
+}
+
+void QOnlineTranslatorTest::abortCached()
+{
+    QOnlineTranslator translator;
+    setupTranslator(translator);
+    auto *cache = new QOnlineTranslationCache(&translator);
+    cache->setMaxDiskEntries(0);
+    translator.setCache(cache);
+
+    QSignalSpy finishedSpy(&translator, &QOnlineTranslator::finished);
+    translator.translate(QStringLiteral("Hello world"), QOnlineTranslator::Google, QOnlineTranslator::German, QOnlineTranslator::English);
+    QVERIFY(finishedSpy.wait(s_timeout));
+
+    // Cached results are delivered asynchronously, so the translation can still be canceled
+    QOnlineTranslationJob *job = translator.startTranslation(QStringLiteral("Hello world"), QOnlineTranslator::Google, QOnlineTranslator::German, QOnlineTranslator::English);
+    QSignalSpy jobSpy(job, &QOnlineTranslationJob::finished);
+    job->abort();
+
+    QVERIFY(jobSpy.wait(s_timeout));
+    QCOMPARE(jobSpy.count(), 1);
+    QCOMPARE(job->error(), QOnlineTranslator::NetworkError);
+    QCOMPARE(job->errorString(), QStringLiteral("Operation canceled"));
+}
+
+void QOnlineTranslatorTest::incrementalTranslation()
+{
+    QOnlineTranslator translator;
+    setupTranslator(translator);
+    auto *cache = new QOnlineTranslationCache(&translator);
+    cache->setMaxDiskEntries(0);
+    translator.setCache(cache);
+    translator.setIncrementalTranslationEnabled(true);
+
+    QString text;
+    for (int i = 0; i < 40; ++i)
+        text += QStringLiteral("Sentence number %1. ").arg(i);
+    text.chop(1);
+    const QVector<QTextSegmenter::Segment> groups = QOnlineTranslationJob::sentenceGroups(text);
+    QVERIFY(groups.size() > 2);
+
+    // Groups are not cached, so the text is translated with a single request
+    QSignalSpy finishedSpy(&translator, &QOnlineTranslator::finished);
+    translator.translate(text, QOnlineTranslator::Google, QOnlineTranslator::German, QOnlineTranslator::English);
+    QVERIFY(finishedSpy.wait(s_timeout));
+    QCOMPARE(m_server.requestCount(), 1);
+
+    // Groups translated as whole texts are reused, only the edited one is requested
+    for (const QTextSegmenter::Segment &group : groups) {
+        translator.translate(text.mid(group.offset, group.length), QOnlineTranslator::Google, QOnlineTranslator::German, QOnlineTranslator::English);
+        QVERIFY(finishedSpy.wait(s_timeout));
+    }
+    m_server.resetRequests();
+
+    text += QStringLiteral(" One more sentence.");
+    translator.translate(text, QOnlineTranslator::Google, QOnlineTranslator::German, QOnlineTranslator::English);
+    QVERIFY(finishedSpy.wait(s_timeout));
+    QVERIFY2(translator.error() == QOnlineTranslator::NoError, qPrintable(translator.errorString()));
+    QCOMPARE(m_server.requestCount(), 1);
+    QCOMPARE(translator.translation().count(QStringLiteral("Hallo Welt")), QOnlineTranslationJob::sentenceGroups(text).size());
+}
+
+void QOnlineTranslatorTest::identicalTranslations()
+{
+    m_server.setLatency(50);
+
+    QOnlineTranslator translator;
+    setupTranslator(translator);
+    QOnlineTranslationJob *firstJob = translator.startTranslation(QStringLiteral("Hello world"), QOnlineTranslator::Google, QOnlineTranslator::German, QOnlineTranslator::English);
+    QOnlineTranslationJob *secondJob = translator.startTranslation(QStringLiteral("Hello world"), QOnlineTranslator::Google, QOnlineTranslator::German, QOnlineTranslator::English);
+
+    QSignalSpy firstSpy(firstJob, &QOnlineTranslationJob::finished);
+    QSignalSpy secondSpy(secondJob, &QOnlineTranslationJob::finished);
+    QVERIFY(firstSpy.wait(s_timeout));
+    QVERIFY(secondSpy.count() == 1 || secondSpy.wait(s_timeout));
+
+    QCOMPARE(firstJob->translation(), QStringLiteral("Hallo Welt"));
+    QCOMPARE(secondJob->translation(), QStringLiteral("Hallo Welt"));
+    QCOMPARE(m_server.requestCount(), 1);
+}
+
+void QOnlineTranslatorTest::schedulerRequestRate()
+{
+    QOnlineTranslator translator;
+    setupTranslator(translator);
+    auto *scheduler = new QOnlineRequestScheduler(&translator);
+    scheduler->setRequestRate(QOnlineTranslator::Google, 10);
+    scheduler->setBurstSize(QOnlineTranslator::Google, 1);
+    translator.setScheduler(scheduler);
+    QSignalSpy delayedSpy(scheduler, &QOnlineRequestScheduler::requestDelayed);
+
+    QElapsedTimer timer;
+    timer.start();
+    QVector<QOnlineTranslationJob *> jobs;
+    for (int i = 0; i < 4; ++i)
+        jobs.append(translator.startTranslation(QStringLiteral("Hello world %1").arg(i), QOnlineTranslator::Google, QOnlineTranslator::German, QOnlineTranslator::English));
+
+    QTRY_VERIFY_WITH_TIMEOUT(std::none_of(jobs.cbegin(), jobs.cend(), [](const QOnlineTranslationJob *job) { return job->isRunning(); }), s_timeout);
+    for (const QOnlineTranslationJob *job : qAsConst(jobs))
+        QVERIFY2(job->error() == QOnlineTranslator::NoError, qPrintable(job->errorString()));
+
+    // One request is sent at once, the rest are sent every 100 ms
+    QCOMPARE(m_server.requestCount(), 4);
+    QVERIFY(timer.elapsed() >= 250);
+    QVERIFY(!delayedSpy.isEmpty());
+}
+
+void QOnlineTranslatorTest::schedulerBackoff()
+{
+    m_server.setErrorRate(1);
+    m_server.setErrorStatus(503);
+
+    QOnlineTranslator translator;
+    setupTranslator(translator);
+    auto *scheduler = new QOnlineRequestScheduler(&translator);
+    scheduler->setMaxBackoff(500);
+    translator.setScheduler(scheduler);
+
+    QSignalSpy finishedSpy(&translator, &QOnlineTranslator::finished);
+    translator.translate(QStringLiteral("Hello world"), QOnlineTranslator::Google, QOnlineTranslator::German, QOnlineTranslator::English);
+    QVERIFY(finishedSpy.wait(s_timeout));
+    QCOMPARE(translator.error(), QOnlineTranslator::ServiceError);
+    QVERIFY(scheduler->backoff(QOnlineTranslator::Google) > 0);
+    QVERIFY(scheduler->backoff(QOnlineTranslator::Google) <= 500);
+
+    // Requests that can't wait until the end of the backoff fail without being sent
+    m_server.setErrorRate(0);
+    m_server.resetRequests();
+    translator.setEngineTimeout(QOnlineTranslator::Google, 10);
+    translator.translate(QStringLiteral("Hello world"), QOnlineTranslator::Google, QOnlineTranslator::German, QOnlineTranslator::English);
+    QVERIFY(finishedSpy.wait(s_timeout));
+    QCOMPARE(translator.error(), QOnlineTranslator::NetworkError);
+    QCOMPARE(m_server.requestCount(), 0);
+
+    // Other requests wait and report the delay
+    QSignalSpy delayedSpy(scheduler, &QOnlineRequestScheduler::requestDelayed);
+    translator.setEngineTimeout(QOnlineTranslator::Google, s_timeout);
+    translator.translate(QStringLiteral("Hello world"), QOnlineTranslator::Google, QOnlineTranslator::German, QOnlineTranslator::English);
+    QVERIFY(finishedSpy.wait(s_timeout));
+    QVERIFY2(translator.error() == QOnlineTranslator::NoError, qPrintable(translator.errorString()));
+    QCOMPARE(m_server.requestCount(), 1);
+    QCOMPARE(delayedSpy.count(), 1);
+    QCOMPARE(delayedSpy.first().first().value<QOnlineTranslator::Engine>(), QOnlineTranslator::Google);
+}
+
+void QOnlineTranslatorTest::orderedParts()
+{
+    m_server.setLatency(100);
+    m_server.setJitter(100);
+
+    QOnlineTranslator translator;
+    setupTranslator(translator);
+    translator.setEngineChunkSize(QOnlineTranslator::Google, 50);
+    translator.setEngineConcurrency(QOnlineTranslator::Google, 4);
+    QSignalSpy finishedSpy(&translator, &QOnlineTranslator::finished);
+    QSignalSpy partsSpy(&translator, &QOnlineTranslator::partialTranslationAvailable);
+
+    const QString text = QStringLiteral("Hello world. ").repeated(40);
+    const int chunks = QTextSegmenter::split(text, 50).size();
+    QElapsedTimer timer;
+    timer.start();
+    translator.translate(text, QOnlineTranslator::Google, QOnlineTranslator::German, QOnlineTranslator::English);
+    QVERIFY(finishedSpy.wait(s_timeout));
+    QVERIFY2(translator.error() == QOnlineTranslator::NoError, qPrintable(translator.errorString()));
+
+    // Parts are sent at the same time, but reported in the order of the text regardless of the response order
+    QVERIFY(timer.elapsed() < chunks * m_server.latency());
+    QCOMPARE(m_server.requestCount(), chunks);
+    QCOMPARE(translator.translation().count(QStringLiteral("Hallo Welt")), chunks);
+
+    QString parts;
+    for (const QList<QVariant> &arguments : qAsConst(partsSpy)) {
+        QCOMPARE(arguments.at(0).toInt(), parts.size());
+        parts += arguments.at(1).toString();
+    }
+    QCOMPARE(parts.count(QStringLiteral("Hallo Welt")), chunks);
+    QVERIFY(translator.translation().startsWith(parts));
+}
+
+void QOnlineTranslatorTest::bingCredentialsExtraction()
+{
+    // Markers are in a different order, next to their prefixes, and followed by a large page that should not be downloaded
+    MockEngineServer::Response page = MockEngineServer::recordedResponse(QStringLiteral("bing-translator-reordered.html"), "text/html");
+    page.body += QByteArray(4 * 1024 * 1024, ' ');
+    m_server.setResponse("/translator", page);
+    QOnlineTranslationJob::clearBingCredentials();
+
+    QOnlineTranslator translator;
+    setupTranslator(translator);
+    QSignalSpy finishedSpy(&translator, &QOnlineTranslator::finished);
+    translator.translate(QStringLiteral("Hello world"), QOnlineTranslator::Bing, QOnlineTranslator::German, QOnlineTranslator::English);
+
+    QVERIFY(finishedSpy.wait(s_timeout));
+    QVERIFY2(translator.error() == QOnlineTranslator::NoError, qPrintable(translator.errorString()));
+    QCOMPARE(QOnlineTranslator::s_bingKey, QByteArray("1700000000000"));
+    QCOMPARE(QOnlineTranslator::s_bingToken, QByteArray("mocktoken"));
+    QCOMPARE(QOnlineTranslator::s_bingIg, QStringLiteral("MOCKIG"));
+    QCOMPARE(QOnlineTranslator::s_bingIid, QStringLiteral("translator.5023"));
+    QCOMPARE(m_server.requestCount("/translator"), 1);
+    const QByteArrayList &paths = m_server.requestedPaths();
+    QVERIFY(std::any_of(paths.cbegin(), paths.cend(), [](const QByteArray &path) {
+        return path.startsWith("/ttranslatev3?IG=MOCKIG&IID=translator.5023");
+    }));
+
+    // Do not leave credentials of the custom page for other tests
+    QOnlineTranslationJob::clearBingCredentials();
+}
+
+void QOnlineTranslatorTest::hedging_data()
+{
+    QTest::addColumn<int>("status");
+    QTest::addColumn<int>("delay");
+    QTest::addColumn<int>("hedgingDelay");
+
+    // Hedging delay is longer than the test timeout, the failure should start the hedging engine immediately
+    QTest::newRow("failed") << 503 << 0 << s_timeout * 2;
+    QTest::newRow("slow") << 200 << s_timeout * 2 << 100;
+}
+
+void QOnlineTranslatorTest::hedging()
+{
+    QFETCH(int, status);
+    QFETCH(int, delay);
+    QFETCH(int, hedgingDelay);
+
+    MockEngineServer::Response googleResponse = MockEngineServer::recordedResponse(QStringLiteral("google-translate.json"));
+    googleResponse.status = status;
+    googleResponse.delay = delay;
+    m_server.setResponse("/translate_a/single", googleResponse);
+
+    QOnlineTranslator translator;
+    setupTranslator(translator);
+    translator.setHedgingEngine(QOnlineTranslator::Lingva);
+    translator.setHedgingDelay(hedgingDelay);
+    QOnlineTranslationJob *job = translator.startTranslation(QStringLiteral("Hello world"), QOnlineTranslator::Google, QOnlineTranslator::German, QOnlineTranslator::English);
+    QSignalSpy finishedSpy(job, &QOnlineTranslationJob::finished);
+
+    QVERIFY(finishedSpy.wait(s_timeout));
+    QVERIFY2(job->error() == QOnlineTranslator::NoError, qPrintable(job->errorString()));
+    QCOMPARE(job->engine(), QOnlineTranslator::Lingva);
+    QCOMPARE(job->translation(), QStringLiteral("Hallo Welt"));
+    QCOMPARE(m_server.requestCount("/translate_a/single"), 1);
+    QCOMPARE(m_server.requestCount("/api/v1/"), 1);
+}
+
+void QOnlineTranslatorTest::batchTranslation()
+{
+    m_server.setResponse("/translate", MockEngineServer::recordedResponse(QStringLiteral("libretranslate-translate-lines.json")));
+
+    QOnlineTranslator translator;
+    setupTranslator(translator);
+    const QStringList texts = {QStringLiteral("Hello"), QStringLiteral("world"), QStringLiteral("Good morning")};
+    QOnlineBatchTranslationJob *job = translator.translateBatch(texts, QOnlineTranslator::LibreTranslate, QOnlineTranslator::German, QOnlineTranslator::English);
+    QSignalSpy finishedSpy(job, &QOnlineBatchTranslationJob::finished);
+
+    // All texts fit into one request
+    QVERIFY(finishedSpy.wait(s_timeout));
+    QVERIFY2(job->error() == QOnlineTranslator::NoError, qPrintable(job->errorString()));
+    QCOMPARE(job->translations(), QStringList({QStringLiteral("Hallo"), QStringLiteral("Welt"), QStringLiteral("Guten Morgen")}));
+    QCOMPARE(m_server.requestCount(), 1);
+}
+
+void QOnlineTranslatorTest::batchLineCountFallback()
+{
+    QOnlineTranslator translator;
+    setupTranslator(translator);
+    const QStringList texts = {QStringLiteral("Hello"), QStringLiteral("world"), QStringLiteral("Good morning")};
+    QOnlineBatchTranslationJob *job = translator.translateBatch(texts, QOnlineTranslator::LibreTranslate, QOnlineTranslator::German, QOnlineTranslator::English);
+    QSignalSpy finishedSpy(job, &QOnlineBatchTranslationJob::finished);
+
+    // The recorded response has a single line, so each text is sent again separately
+    QVERIFY(finishedSpy.wait(s_timeout));
+    QVERIFY2(job->error() == QOnlineTranslator::NoError, qPrintable(job->errorString()));
+    QCOMPARE(job->translations(), QStringList(texts.size(), QStringLiteral("Hallo Welt")));
+    QCOMPARE(m_server.requestCount(), texts.size() + 1);
+}
+
+void QOnlineTranslatorTest::textSegmenter_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<int>("limit");
+    QTest::addColumn<QStringList>("parts");
+
+    QTest::newRow("empty") << QString() << 10 << QStringList();
+    QTest::newRow("short") << QStringLiteral("Hello world") << 20 << QStringList{QStringLiteral("Hello world")};
+    QTest::newRow("sentences") << QStringLiteral("Hello world. How are you?") << 20 << QStringList{QStringLiteral("Hello world. "), QStringLiteral("How are you?")};
+    QTest::newRow("small sentence") << QStringLiteral("A. bcdefgh ijklmnop") << 12 << QStringList{QStringLiteral("A. bcdefgh "), QStringLiteral("ijklmnop")};
+    QTest::newRow("CJK") << QStringLiteral("你好世界。今天天气很好。") << 8 << QStringList{QStringLiteral("你好世界。"), QStringLiteral("今天天气很好。")};
+    QTest::newRow("no breaks") << QStringLiteral("abcdefghij") << 4 << QStringList{QStringLiteral("abcd"), QStringLiteral("efgh"), QStringLiteral("ij")};
+    QTest::newRow("surrogate pair") << QStringLiteral("abc\U0001F600d") << 4 << QStringList{QStringLiteral("abc"), QStringLiteral("\U0001F600d")};
+}
+
+void QOnlineTranslatorTest::textSegmenter()
+{
+    QFETCH(QString, text);
+    QFETCH(int, limit);
+    QFETCH(QStringList, parts);
+
+    QStringList segmentedParts;
+    int offset = 0;
+    for (const QTextSegmenter::Segment &segment : QTextSegmenter::split(text, limit)) {
+        QCOMPARE(segment.offset, offset);
+        QVERIFY(segment.length <= limit);
+        segmentedParts.append(text.mid(segment.offset, segment.length));
+        offset += segment.length;
+    }
+
+    QCOMPARE(segmentedParts, parts);
+    QCOMPARE(offset, text.size());
+}
+
+void QOnlineTranslatorTest::languageTables_data()
+{
+    QTest::addColumn<QOnlineTranslator::Engine>("engine");
+
+    QTest::newRow("Google") << QOnlineTranslator::Google;
+    QTest::newRow("Yandex") << QOnlineTranslator::Yandex;
+    QTest::newRow("Bing") << QOnlineTranslator::Bing;
+    QTest::newRow("LibreTranslate") << QOnlineTranslator::LibreTranslate;
+    QTest::newRow("Lingva") << QOnlineTranslator::Lingva;
+}
+
+void QOnlineTranslatorTest::languageTables()
+{
+    QFETCH(QOnlineTranslator::Engine, engine);
+
+    const QVector<QOnlineTranslator::Language> languages = QOnlineTranslator::supportedLanguages(engine);
+    QVERIFY(!languages.isEmpty());
+    QVERIFY(!languages.contains(QOnlineTranslator::Auto));
+    QVERIFY(std::is_sorted(languages.cbegin(), languages.cend()));
+
+    for (int i = QOnlineTranslator::Auto + 1; i <= QOnlineTranslator::Zulu; ++i) {
+        const auto lang = static_cast<QOnlineTranslator::Language>(i);
+        const QString code = QOnlineTranslator::languageApiCode(engine, lang);
+        QCOMPARE(QOnlineTranslator::isSupportTranslation(engine, lang), languages.contains(lang));
+        if (!QOnlineTranslator::isSupportTranslation(engine, lang)) {
+            QVERIFY(code.isEmpty());
+            continue;
+        }
+
+        // Codes are resolved back to the same language
+        QVERIFY(!code.isEmpty());
+        QCOMPARE(QOnlineTranslator::language(engine, code), lang);
+    }
+
+    // Engine-specific codes take precedence, generic codes are still recognized in responses
+    QCOMPARE(QOnlineTranslator::languageApiCode(QOnlineTranslator::Google, QOnlineTranslator::Hebrew), QStringLiteral("iw"));
+    QCOMPARE(QOnlineTranslator::language(QOnlineTranslator::Google, QStringLiteral("he")), QOnlineTranslator::Hebrew);
+    QCOMPARE(QOnlineTranslator::languageApiCode(QOnlineTranslator::Bing, QOnlineTranslator::SimplifiedChinese), QStringLiteral("zh-Hans"));
+    QCOMPARE(QOnlineTranslator::language(engine, QStringLiteral("unknown")), QOnlineTranslator::NoLanguage);
+    QVERIFY(!QOnlineTranslator::isSupportTranslation(engine, QOnlineTranslator::NoLanguage));
+}
+
+void QOnlineTranslatorTest::languageIdentifier_data()
+{
+    QTest::addColumn<QString>("text");
+    QTest::addColumn<QOnlineTranslator::Language>("language");
+    QTest::addColumn<double>("minConfidence");
+    QTest::addColumn<double>("maxConfidence");
+
+    QTest::newRow("empty") << QString() << QOnlineTranslator::NoLanguage << 0.0 << 0.0;
+    QTest::newRow("no letters") << QStringLiteral("12345 !?") << QOnlineTranslator::NoLanguage << 0.0 << 0.0;
+    QTest::newRow("Greek") << QStringLiteral("Καλημέρα σας, πώς είστε σήμερα;") << QOnlineTranslator::Greek << 0.9 << 1.0;
+    QTest::newRow("Japanese") << QStringLiteral("東京都新宿区の天気予報") << QOnlineTranslator::Japanese << 0.9 << 1.0;
+    // Yiddish uses the same script, so the result is never trusted without the engine
+    QTest::newRow("Hebrew") << QStringLiteral("שלום עולם, מה שלומך היום?") << QOnlineTranslator::Hebrew << 0.0 << 0.5;
+    QTest::newRow("English") << QStringLiteral("The weather is very nice today, so we are going to walk in the park with our friends.")
+                             << QOnlineTranslator::English << 0.0 << 1.0;
+    QTest::newRow("German") << QStringLiteral("Das Wetter ist heute sehr schön, deshalb gehen wir mit unseren Freunden im Park spazieren.")
+                            << QOnlineTranslator::German << 0.0 << 1.0;
+}
+
+void QOnlineTranslatorTest::languageIdentifier()
+{
+    QFETCH(QString, text);
+    QFETCH(QOnlineTranslator::Language, language);
+    QFETCH(double, minConfidence);
+    QFETCH(double, maxConfidence);
+
+    const QLanguageIdentifier::Result result = QLanguageIdentifier::identify(text);
+    QCOMPARE(result.language, language);
+    QVERIFY(result.confidence >= minConfidence);
+    QVERIFY(result.confidence <= maxConfidence);
+}
+
+void QOnlineTranslatorTest::setupTranslator(QOnlineTranslator &translator) const
+{
+    translator.setEngineUrl(QOnlineTranslator::Google, m_server.url());
+    translator.setEngineUrl(QOnlineTranslator::Yandex, m_server.url());
+    translator.setEngineUrl(QOnlineTranslator::Bing, m_server.url());
+    translator.setEngineUrl(QOnlineTranslator::LibreTranslate, m_server.url());
+    translator.setEngineUrl(QOnlineTranslator::Lingva, m_server.url());
+}
+
+QTEST_GUILESS_MAIN(QOnlineTranslatorTest)
+
+#include "qonlinetranslatortest.moc"
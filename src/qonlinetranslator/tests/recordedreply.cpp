@@ -0,0 +1,58 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#include "recordedreply.h"
+
+#include <cstring>
+
+RecordedReply::RecordedReply(const QByteArray &data, QObject *parent, const QNetworkRequest &request)
+    : QNetworkReply(parent)
+    , m_data(data)
+{
+    setRequest(request);
+    setUrl(request.url());
+    setAttribute(QNetworkRequest::HttpStatusCodeAttribute, 200);
+    setOperation(QNetworkAccessManager::GetOperation);
+    open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+    setFinished(true);
+}
+
+void RecordedReply::abort()
+{
+}
+
+bool RecordedReply::isSequential() const
+{
+    return true;
+}
+
+qint64 RecordedReply::bytesAvailable() const
+{
+    return m_data.size() - m_offset + QNetworkReply::bytesAvailable();
+}
+
+qint64 RecordedReply::readData(char *data, qint64 maxSize)
+{
+    const qint64 size = qMin(maxSize, static_cast<qint64>(m_data.size() - m_offset));
+    std::memcpy(data, m_data.constData() + m_offset, static_cast<size_t>(size));
+    m_offset += size;
+    return size;
+}
+
+void RecordedNetworkAccessManager::setResponse(const QString &path, const QByteArray &data)
+{
+    m_responses.insert(path, data);
+}
+
+QNetworkReply *RecordedNetworkAccessManager::createRequest(Operation, const QNetworkRequest &request, QIODevice *)
+{
+    auto *reply = new RecordedReply(m_responses.value(request.url().path()), this, request);
+
+    // Finish from the event loop like a real reply
+    QMetaObject::invokeMethod(reply, "finished", Qt::QueuedConnection);
+    return reply;
+}
@@ -0,0 +1,62 @@
+/*
+ * SPDX-FileCopyrightText: 2018 Hennadii Chernyshchyk <genaloner@gmail.com>
+ * SPDX-FileCopyrightText: 2022 Volk Milit <javirrdar@gmail.com>
+ *
+ * SPDX-License-Identifier: GPL-3.0-or-later
+ */
+
+#ifndef RECORDEDREPLY_H
+#define RECORDEDREPLY_H
+
+#include <QHash>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+
+/**
+ * @brief Finished reply with a recorded response
+ *
+ * Used to feed responses to parsers without network.
+ */
+class RecordedReply : public QNetworkReply
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(RecordedReply)
+
+public:
+    explicit RecordedReply(const QByteArray &data, QObject *parent = nullptr, const QNetworkRequest &request = QNetworkRequest());
+
+    void abort() override;
+    bool isSequential() const override;
+    qint64 bytesAvailable() const override;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+
+private:
+    QByteArray m_data;
+    qint64 m_offset = 0;
+};
+
+/**
+ * @brief Network manager that answers requests with recorded responses
+ *
+ * Responses are chosen by the URL path and finished from the event loop like real replies.
+ */
+class RecordedNetworkAccessManager : public QNetworkAccessManager
+{
+    Q_OBJECT
+    Q_DISABLE_COPY(RecordedNetworkAccessManager)
+
+public:
+    using QNetworkAccessManager::QNetworkAccessManager;
+
+    void setResponse(const QString &path, const QByteArray &data);
+
+protected:
+    QNetworkReply *createRequest(Operation, const QNetworkRequest &request, QIODevice *) override;
+
+private:
+    QHash<QString, QByteArray> m_responses;
+};
+
+#endif // RECORDEDREPLY_H
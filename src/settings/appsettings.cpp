@@ -446,6 +446,21 @@ bool AppSettings::defaultSimplifySource()
     return false;
 }
 
+AppSettings::TranslationCacheMode AppSettings::translationCacheMode() const
+{
+    return m_settings->value(QStringLiteral("Translation/CacheMode"), defaultTranslationCacheMode()).value<TranslationCacheMode>();
+}
+
+void AppSettings::setTranslationCacheMode(TranslationCacheMode mode)
+{
+    m_settings->setValue(QStringLiteral("Translation/CacheMode"), mode);
+}
+
+AppSettings::TranslationCacheMode AppSettings::defaultTranslationCacheMode()
+{
+    return MemoryCache;
+}
+
 QOnlineTranslator::Language AppSettings::primaryLanguage() const
 {
     return m_settings->value(QStringLiteral("Translation/PrimaryLanguage"), defaultPrimaryLanguage()).value<QOnlineTranslator::Language>();
@@ -57,6 +57,13 @@ public:
     };
     Q_ENUM(IconType)
 
+    enum TranslationCacheMode {
+        NoCache,
+        MemoryCache,
+        DiskCache
+    };
+    Q_ENUM(TranslationCacheMode)
+
 #ifdef Q_OS_WIN
     enum Interval {
         Day,
@@ -177,6 +184,10 @@ public:
     void setSimplifySource(bool simplify);
     static bool defaultSimplifySource();
 
+    TranslationCacheMode translationCacheMode() const;
+    void setTranslationCacheMode(TranslationCacheMode mode);
+    static TranslationCacheMode defaultTranslationCacheMode();
+
     QOnlineTranslator::Language primaryLanguage() const;
     void setPrimaryLanguage(QOnlineTranslator::Language lang);
     static QOnlineTranslator::Language defaultPrimaryLanguage();
@@ -90,16 +90,17 @@ SettingsDialog::SettingsDialog(MainWindow *parent)
 
     ui->primaryLangComboBox->addItem(tr("<System language>"), QOnlineTranslator::Auto);
     ui->secondaryLangComboBox->addItem(tr("<System language>"), QOnlineTranslator::Auto);
-    for (int i = 1; i <= QOnlineTranslator::Zulu; ++i) {
-        const auto lang = static_cast<QOnlineTranslator::Language>(i);
+    for (QOnlineTranslator::Language lang : QOnlineTranslator::supportedLanguages()) {
         const QIcon langIcon = LanguageButtonsWidget::countryIcon(lang);
 
-        ui->primaryLangComboBox->addItem(langIcon, QOnlineTranslator::languageName(lang), i);
-        ui->secondaryLangComboBox->addItem(langIcon, QOnlineTranslator::languageName(lang), i);
+        ui->primaryLangComboBox->addItem(langIcon, QOnlineTranslator::languageName(lang), lang);
+        ui->secondaryLangComboBox->addItem(langIcon, QOnlineTranslator::languageName(lang), lang);
     }
 
     ui->ocrLanguagesListWidget->addLanguages(parent->ocr()->availableLanguages());
 
+    connect(ui->clearCacheButton, &QPushButton::clicked, parent, &MainWindow::clearTranslationCache);
+
     for (QOnlineTranslator::Language configurableLang : QOnlineTts::validRegions().keys())
         ui->googleLanguageComboBox->addItem(QOnlineTranslator::languageName(configurableLang), configurableLang);
 
@@ -233,6 +234,7 @@ void SettingsDialog::accept()
     settings.setTranslationOptionsEnabled(ui->translationOptionsCheckBox->isChecked());
     settings.setExamplesEnabled(ui->examplesCheckBox->isChecked());
     settings.setSimplifySource(ui->sourceSimplificationCheckBox->isChecked());
+    settings.setTranslationCacheMode(static_cast<AppSettings::TranslationCacheMode>(ui->cacheModeComboBox->currentIndex()));
     settings.setPrimaryLanguage(ui->primaryLangComboBox->currentData().value<QOnlineTranslator::Language>());
     settings.setSecondaryLanguage(ui->secondaryLangComboBox->currentData().value<QOnlineTranslator::Language>());
     settings.setForceSourceAutodetect(ui->forceSourceAutodetectCheckBox->isChecked());
@@ -544,6 +546,7 @@ void SettingsDialog::restoreDefaults()
     ui->translationOptionsCheckBox->setChecked(AppSettings::defaultTranslationOptionsEnabled());
     ui->examplesCheckBox->setChecked(AppSettings::defaultExamplesEnabled());
     ui->sourceSimplificationCheckBox->setChecked(AppSettings::defaultSimplifySource());
+    ui->cacheModeComboBox->setCurrentIndex(AppSettings::defaultTranslationCacheMode());
     ui->primaryLangComboBox->setCurrentIndex(ui->primaryLangComboBox->findData(AppSettings::defaultPrimaryLanguage()));
     ui->secondaryLangComboBox->setCurrentIndex(ui->secondaryLangComboBox->findData(AppSettings::defaultSecondaryLanguage()));
     ui->forceSourceAutodetectCheckBox->setChecked(AppSettings::defaultForceSourceAutodetect());
@@ -655,6 +658,7 @@ void SettingsDialog::loadSettings()
     ui->translationOptionsCheckBox->setChecked(settings.isTranslationOptionsEnabled());
     ui->examplesCheckBox->setChecked(settings.isExamplesEnabled());
     ui->sourceSimplificationCheckBox->setChecked(settings.isSimplifySource());
+    ui->cacheModeComboBox->setCurrentIndex(settings.translationCacheMode());
     ui->primaryLangComboBox->setCurrentIndex(ui->primaryLangComboBox->findData(settings.primaryLanguage()));
     ui->secondaryLangComboBox->setCurrentIndex(ui->secondaryLangComboBox->findData(settings.secondaryLanguage()));
     ui->forceSourceAutodetectCheckBox->setChecked(settings.isForceSourceAutodetect());
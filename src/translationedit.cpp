@@ -29,14 +29,7 @@ bool TranslationEdit::parseTranslationData(QOnlineTranslator *translator)
     m_translation = translator->translation();
     m_lang = translator->translationLanguage();
 
-    // Remove bad chars
-    // Note: this hack is here, because toHtml() can't render anything with utf-8 characters
-    for (int i = 0; i < m_translation.size(); ++i) {
-        if (m_translation[i].category() == QChar::Symbol_Other) {
-            m_translation.remove(i, 1);
-            --i;
-        }
-    }
+    removeBadChars(m_translation);
 
     // Translation
     setHtml(m_translation.toHtmlEscaped().replace(QStringLiteral("\n"), QStringLiteral("<br>")));
@@ -118,6 +111,29 @@ bool TranslationEdit::parseTranslationData(QOnlineTranslator *translator)
     return true;
 }
 
+// Show received parts of the translation, the complete translation data will replace them
+void TranslationEdit::parsePartialTranslation(QOnlineTranslator *translator, int offset, const QString &text)
+{
+    QString part = text;
+    const bool first = offset == 0 || offset != m_partialTranslationSize;
+    if (offset == 0) {
+        clear(); // The first part of a new translation
+    } else if (offset != m_partialTranslationSize) {
+        // Show all received parts if previous ones are missed
+        clear();
+        part = translator->translation();
+    }
+    m_partialTranslationSize = offset + text.size();
+
+    removeBadChars(part);
+    QTextCursor cursor = textCursor();
+    cursor.movePosition(QTextCursor::End);
+    cursor.insertText(part);
+
+    // Only the part is sent, converting the whole document on each part would be quadratic for long texts
+    emit translationPartParsed(part, first);
+}
+
 const QString &TranslationEdit::translation() const
 {
     return m_translation;
@@ -143,3 +159,14 @@ void TranslationEdit::contextMenuEvent(QContextMenuEvent *event)
     auto *contextMenu = new ContextMenu(this, event);
     contextMenu->popup();
 }
+
+// Note: this hack is here, because toHtml() can't render anything with utf-8 characters
+void TranslationEdit::removeBadChars(QString &text)
+{
+    for (int i = 0; i < text.size(); ++i) {
+        if (text[i].category() == QChar::Symbol_Other) {
+            text.remove(i, 1);
+            --i;
+        }
+    }
+}
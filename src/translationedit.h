@@ -21,20 +21,25 @@ public:
     explicit TranslationEdit(QWidget *parent = nullptr);
 
     bool parseTranslationData(QOnlineTranslator *translator);
+    void parsePartialTranslation(QOnlineTranslator *translator, int offset, const QString &text);
     const QString &translation() const;
     QOnlineTranslator::Language translationLanguage();
     void clearTranslation();
 
 signals:
     void translationDataParsed(const QString &text);
+    void translationPartParsed(const QString &part, bool first); // The first part replaces the shown text
     void translationEmpty(bool empty);
 
 protected:
     void contextMenuEvent(QContextMenuEvent *event) override;
 
 private:
+    static void removeBadChars(QString &text);
+
     QString m_translation;
     QOnlineTranslator::Language m_lang = QOnlineTranslator::NoLanguage;
+    int m_partialTranslationSize = 0; // Received size of the translation that is shown by parts
 };
 
 #endif // TRANSLATIONEDIT_H